@@ -0,0 +1,249 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <iomanip> // std::setw
+#include <chrono>
+#include <string>
+#include <vector>
+#include <utility> // std::pair
+#include <algorithm> // std::min, std::find, std::find_if
+#include <regex>
+#include <stdexcept> // std::runtime_error
+
+#include "weighted_vector.h"
+#include "random.h"
+#include "note.h"
+#include "notevalue.h"
+#include "note_numbers.h"
+#include "bassutils.h"
+#include "simpleBassline.h"
+#include "walkingbass.h"
+#include "stylebundle.h"
+#include "progression.h" // comper::readProgression
+#include "baseline/simpleBassline.h" // baseline::comper::genSimpleWalkingBassline
+#include "baseline/probcfg.h"
+#include "baseline/note.h"
+
+// Results are added into this so the work being timed can't be optimized away
+volatile long long benchSink = 0;
+
+/**
+ * Run `work`, which does `count` operations, `runs` times and return how many nanoseconds one operation
+ * took in the fastest run. The fastest run is the one least disturbed by everything else on the machine
+ */
+template <typename Work>
+double nanosecondsEach(Work work, const long long count, const int runs = 5) {
+    double best = 1e300;
+    for(int run = 0; run < runs; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        work();
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count() / count);
+    }
+    return best;
+}
+
+// Alias table draws against the linear scan they replaced, for rules with 2 to 1000 alternatives
+void benchAliasTable() {
+    const int draws = 1000000;
+    std::cout << "alternatives  linear scan(ns)  alias table(ns)  speedup" << std::endl << std::fixed;
+    for(int alternatives : {2, 5, 10, 20, 50, 100, 200, 500, 1000}) {
+        Random weightRandom(alternatives);
+        std::vector<int> elements, weights;
+        for(int i = 0; i < alternatives; ++i) {
+            elements.push_back(i);
+            weights.push_back(1 + weightRandom.bounded(100));
+        }
+        // Inserting one element at a time leaves the vector unfrozen, so it scans like it used to
+        weightedVector<int> alias(elements, weights), linear;
+        for(int i = 0; i < alternatives; ++i) {
+            linear.insert(elements[i], weights[i]);
+        }
+        auto draw = [draws](const weightedVector<int> &vector) {
+            return [&vector, draws]() {
+                Random random(1);
+                long long sum = 0;
+                for(int i = 0; i < draws; ++i) {
+                    sum += vector.getElement(random);
+                }
+                benchSink = benchSink + sum;
+            };
+        };
+        double linearTime = nanosecondsEach(draw(linear), draws);
+        double aliasTime = nanosecondsEach(draw(alias), draws);
+        std::cout << std::setw(12) << alternatives << std::setw(17) << linearTime << std::setw(17) << aliasTime
+                  << std::setw(8) << linearTime / aliasTime << "x" << std::endl;
+    }
+}
+
+// The midi number of note `name` in octave `octave` found with the regexes Note::number used to use
+int regexNoteNumber(const std::string &name, const int octave) {
+    if(!std::regex_match(name, std::regex("^[A-Ga-g](.*)"))) {
+        throw std::runtime_error(name + " is an invalid note name");
+    }
+    int midiNumber = letterNumber(name[0]);
+    std::string accidentals = name.substr(1);
+    if(std::regex_search(accidentals, std::regex("##"))) {
+        midiNumber += 2;
+    } else if(std::regex_search(accidentals, std::regex("#"))) {
+        ++midiNumber;
+    } else if(std::regex_search(accidentals, std::regex("bb"))) {
+        midiNumber -= 2;
+    } else if(std::regex_search(accidentals, std::regex("b"))) {
+        --midiNumber;
+    }
+    if(midiNumber < 0) {
+        midiNumber += NUM_NOTES;
+    }
+    return midiNumber + NUM_NOTES * (octave - MIDI_START_OCTAVE);
+}
+
+/* comper::closestNote the way it used to work, going through Note::closest and Note::setOctave, each of which
+ * parsed the note's name again */
+int regexClosestNote(const std::string &name, const int comparison, const comper::Direction dir) {
+    int octave = MIDI_START_OCTAVE + comparison / NUM_NOTES;
+    int number = regexNoteNumber(name, octave);
+    if(number < comparison - NUM_NOTES / 2) {
+        number = regexNoteNumber(name, ++octave);
+    } else if(number > comparison + NUM_NOTES / 2) {
+        number = regexNoteNumber(name, --octave);
+    }
+    if(number != comparison && (number > comparison) != dir) {
+        number = regexNoteNumber(name, dir ? octave + 1 : octave - 1);
+    }
+    return number;
+}
+
+/* Finding the closest note with a given name in a direction, the step every bass note takes, with the regexes
+ * note names used to be parsed with, with the table parser, and on NoteValues without any names */
+void benchClosestNote() {
+    const int count = 1 << 20, regexCount = 1 << 14;
+    // Every lookup is for one of these notes near one of these midi numbers
+    std::vector<std::string> names;
+    std::vector<NoteValue> values;
+    std::vector<int> comparisons;
+    Random random(1);
+    for(int i = 0; i < 1024; ++i) {
+        names.push_back(MIDI_NAMES[random.bounded(NUM_NOTES)]);
+        values.push_back(Note(names.back()).value());
+        comparisons.push_back(36 + random.bounded(24));
+    }
+    auto lookups = [&](const int lookupCount, auto lookup) {
+        return [&, lookupCount, lookup]() {
+            long long sum = 0;
+            for(int i = 0; i < lookupCount; ++i) {
+                sum += lookup(i % 1024, (comper::Direction)(i & 1));
+            }
+            benchSink = benchSink + sum;
+        };
+    };
+    double regexTime = nanosecondsEach(lookups(regexCount, [&](const int i, const comper::Direction dir) {
+        return regexClosestNote(names[i], comparisons[i], dir);
+    }), regexCount, 3);
+    double tableTime = nanosecondsEach(lookups(count, [&](const int i, const comper::Direction dir) {
+        return comper::closestNote(Note(names[i]).value(), NoteValue(comparisons[i]), dir).number();
+    }), count);
+    double valueTime = nanosecondsEach(lookups(count, [&](const int i, const comper::Direction dir) {
+        return comper::closestNote(values[i], NoteValue(comparisons[i]), dir).number();
+    }), count);
+    // Make sure every way finds the same notes
+    for(int i = 0; i < 1024; ++i) {
+        if(regexClosestNote(names[i], comparisons[i], (comper::Direction)(i & 1)) !=
+                comper::closestNote(values[i], NoteValue(comparisons[i]), (comper::Direction)(i & 1)).number()) {
+            throw std::runtime_error("closestNote disagrees with the regex parser for " + names[i]);
+        }
+    }
+    std::cout << "regex names(ns)  table names(ns)  values(ns)" << std::endl << std::fixed;
+    std::cout << std::setw(15) << regexTime << std::setw(17) << tableTime << std::setw(12) << valueTime
+              << std::endl;
+    std::cout << "table names are " << regexTime / tableTime << "x faster and values are " << regexTime / valueTime
+              << "x faster than regex names" << std::endl;
+}
+
+/* genWalkingBassline against genSimpleWalkingBassline, which it replaced, and against genSimpleWalkingBassline
+ * the way it was before generation was rewritten(kept under baseline/), on 1000 choruses of dexterity */
+void benchWalkingBass() {
+    const int choruses = 1000;
+    StyleBundle style;
+    style.fromFile(SAMPLES_DIR "/sample_style_files/sample.style");
+    const std::vector<comper::quarterNoteChord> progression =
+            comper::readProgression(SAMPLES_DIR "/sample_progressions/dexterity.progression", choruses);
+    const ProbCFG &pattern = style["bassPattern"], &direction = style["bassDirection"];
+    const Note lowest("C", 3), highest("G", 3);
+    /* The old engine gets its own copy of everything. It takes over a minute for 1000 choruses, so it's timed
+     * on baselineChoruses of them and scaled up, which is fair since it takes the same time for every chorus */
+    const int baselineChoruses = 20;
+    std::vector<baseline::comper::quarterNoteChord> baselineProgression;
+    for(const comper::quarterNoteChord &chord : std::vector<comper::quarterNoteChord>(progression.begin(),
+            progression.begin() + progression.size() / choruses * baselineChoruses)) {
+        baselineProgression.push_back(baseline::comper::quarterNoteChord(chord.name()));
+        baselineProgression.back().setDuration(chord.duration());
+        baselineProgression.back().setVelocity(chord.velocity());
+    }
+    baseline::ProbCFG baselinePattern, baselineDirection;
+    baselinePattern.fromFile(SAMPLES_DIR "/sample_style_files/sample.style", "bassPattern");
+    baselineDirection.fromFile(SAMPLES_DIR "/sample_style_files/sample.style", "bassDirection");
+    size_t notes = 0;
+    // Each run counts as a million operations so the times come out in milliseconds
+    double baselineTime = nanosecondsEach([&]() {
+        benchSink = benchSink + baseline::comper::genSimpleWalkingBassline(baselineProgression, baselinePattern,
+                baselineDirection, baseline::Note("C", 3), baseline::Note("G", 3)).size();
+    }, 1000000 / (choruses / baselineChoruses), 3);
+    double simpleTime = nanosecondsEach([&]() {
+        Random random(1);
+        notes = comper::genSimpleWalkingBassline(progression, pattern, direction, lowest, highest, random).size();
+    }, 1000000, 15);
+    double stateMachineTime = nanosecondsEach([&]() {
+        Random random(1);
+        benchSink = benchSink + comper::genWalkingBassline(progression, pattern, direction, lowest, highest,
+                                                           random).size();
+    }, 1000000, 15);
+    std::cout << choruses << " choruses of dexterity: " << progression.size() << " chords, " << notes << " notes"
+              << std::endl << std::fixed;
+    std::cout << "before the rewrite(ms, scaled from " << baselineChoruses << " choruses)  "
+              << "genSimpleWalkingBassline(ms)  genWalkingBassline(ms)" << std::endl;
+    std::cout << std::setw(50) << baselineTime << std::setw(30) << simpleTime << std::setw(24) << stateMachineTime
+              << std::endl;
+    std::cout << "genWalkingBassline is " << baselineTime / stateMachineTime << "x faster than before the rewrite ("
+              << (baselineTime >= 10 * stateMachineTime ? "meets" : "misses") << " the 10x target) and "
+              << simpleTime / stateMachineTime << "x faster than genSimpleWalkingBassline" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    const std::vector<std::pair<std::string, void (*)()>> benchmarks = {
+        {"alias", benchAliasTable},
+        {"closestnote", benchClosestNote},
+        {"walkingbass", benchWalkingBass},
+    };
+    std::vector<std::string> names(argv + 1, argv + argc);
+    for(const std::string &name : names) {
+        if(std::find_if(benchmarks.begin(), benchmarks.end(), [&name](const auto &benchmark) {
+                return benchmark.first == name;}) == benchmarks.end()) {
+            std::cout << "Unknown benchmark " << name << std::endl;
+            return 1;
+        }
+    }
+    std::cout << std::setprecision(1);
+    for(const auto &benchmark : benchmarks) {
+        if(names.empty() || std::find(names.begin(), names.end(), benchmark.first) != names.end()) {
+            std::cout << "[" << benchmark.first << "]" << std::endl;
+            benchmark.second();
+        }
+    }
+    return 0;
+}
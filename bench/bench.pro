@@ -0,0 +1,29 @@
+# Microbenchmarks for the hot paths of generation. Build with optimizations and run with the names of the
+# benchmarks to run, or nothing to run them all
+include(../comper.pri)
+
+TARGET = comper-bench
+CONFIG += console
+CONFIG -= app_bundle
+DEFINES += SAMPLES_DIR=\\\"$$PWD/..\\\"
+
+SOURCES += \
+     bench.cpp
+
+# The walking bass engine as it was before generation was rewritten, in namespace baseline, to time the new one
+# against. Its sources share names with the ones in src, so their objects go beside them instead
+CONFIG += object_parallel_to_source
+
+SOURCES += \
+     baseline/chord.cpp \
+     baseline/note.cpp \
+     baseline/probcfg.cpp
+
+HEADERS += \
+     baseline/bassutils.h \
+     baseline/chord.h \
+     baseline/note.h \
+     baseline/note_numbers.h \
+     baseline/probcfg.h \
+     baseline/simpleBassline.h \
+     baseline/weighted_vector.h
@@ -0,0 +1,61 @@
+# Everything comper is made of except main.cpp, shared by comper.pro and the benchmarks
+QT       += core
+CONFIG   += c++17
+
+INCLUDEPATH += $$PWD/src
+
+SOURCES += \
+     $$PWD/src/cfgstream.cpp \
+     $$PWD/src/chord.cpp \
+     $$PWD/src/chordsymbol.cpp \
+     $$PWD/src/compiledcfg.cpp \
+     $$PWD/src/compiledstyle.cpp \
+     $$PWD/src/lengthbounds.cpp \
+     $$PWD/src/note.cpp \
+     $$PWD/src/prefixdistribution.cpp \
+     $$PWD/src/probcfg.cpp \
+     $$PWD/src/progression.cpp \
+     $$PWD/src/midiwriter.cpp \
+     $$PWD/src/stylebundle.cpp \
+     $$PWD/src/midifile/Binasc.cpp \
+     $$PWD/src/midifile/MidiEvent.cpp \
+     $$PWD/src/midifile/MidiEventList.cpp \
+     $$PWD/src/midifile/MidiFile.cpp \
+     $$PWD/src/midifile/MidiMessage.cpp
+
+HEADERS += \
+     $$PWD/src/cfgstream.h \
+     $$PWD/src/chord.h \
+     $$PWD/src/chord_tables.h \
+     $$PWD/src/chordsymbol.h \
+     $$PWD/src/chordvalue.h \
+     $$PWD/src/comp.h \
+     $$PWD/src/compiledcfg.h \
+     $$PWD/src/compiledstyle.h \
+     $$PWD/src/lengthbounds.h \
+     $$PWD/src/note.h \
+     $$PWD/src/note_numbers.h \
+     $$PWD/src/optimalbass.h \
+     $$PWD/src/notevalue.h \
+     $$PWD/src/prefixdistribution.h \
+     $$PWD/src/probcfg.h \
+     $$PWD/src/progression.h \
+     $$PWD/src/random.h \
+     $$PWD/src/weighted_vector.h \
+     $$PWD/src/simpleBassline.h \
+     $$PWD/src/stringbatch.h \
+     $$PWD/src/stylebundle.h \
+     $$PWD/src/stylecontract.h \
+     $$PWD/src/walkingbass.h \
+     $$PWD/src/midiwriter.h \
+     $$PWD/src/midifile/Binasc.h \
+     $$PWD/src/midifile/MidiEvent.h \
+     $$PWD/src/midifile/MidiEventList.h \
+     $$PWD/src/midifile/MidiFile.h \
+     $$PWD/src/midifile/MidiMessage.h
+
+# The hot reloading style cache uses inotify
+linux {
+    SOURCES += $$PWD/src/stylecache.cpp
+    HEADERS += $$PWD/src/stylecache.h
+}
@@ -22,26 +22,29 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 #include <algorithm> // std::copy_if
 
 #include "note.h"
-#include "chord.h"
+#include "chordvalue.h"
+#include "notevalue.h"
+#include "note_numbers.h"
 
 namespace comper {
     enum Direction : bool {Up = true, Down = false};
-    /* Finds the closest note with the same name as `original` to `comparison` in direction `dir`
+    /* Finds the closest note with the same pitch class as `original` to `comparison` in direction `dir`.
+     * The result has comparison's duration and velocity
      * Ex: If original is a C4 and comparison is a D5 and dir is up, we return a C6
      */
-    Note closestNote(Note original, Note comparison, Direction dir) {
-        original = comparison.closest(original.name());
+    NoteValue closestNote(NoteValue original, NoteValue comparison, Direction dir) {
+        original = comparison.closest(original.pitchClass());
         if(original == comparison) {
             return original;
         }
         // Make sure original is in the right direction from comparison and adjust its octave accordingly
         if((original > comparison) != dir) {
-            original.setOctave(dir ? original.octave() + 1 : original.octave() - 1);
+            original = original + (dir ? NUM_NOTES : -NUM_NOTES);
         }
         return original;
     }
 
-    bool isBetween(const Note &original, const Note &comparison1, const Note &comparison2) {
+    bool isBetween(const NoteValue original, const NoteValue comparison1, const NoteValue comparison2) {
         return std::max(comparison1.number(), comparison2.number()) > original.number() &&
                 std::min(comparison1.number(), comparison2.number()) < original.number();
     }
@@ -60,7 +63,8 @@ namespace comper {
      * @example leadingNote(E, G, C, Down) == D
      * actual note/chord objects left out for the sake of illustration
      */
-    Note closestLeadingNote(Note currentNote, Note nextNote, Chord currentChord, Direction dir) {
+    NoteValue closestLeadingNote(NoteValue currentNote, NoteValue nextNote, const ChordValue &currentChord,
+            Direction dir) {
         nextNote = closestNote(nextNote, currentNote, dir);
         // Return a fifth above/fourth below depending on dir if currentNote and nextNote are identical
         if(currentNote == nextNote) {
@@ -72,50 +76,65 @@ namespace comper {
         }
         /* Adjust the octaves of each chordTone to be as close as possible to currentNote in the correct
          * direction. Find the neighboring chordTone to nextNote and check if the 5th above/4th below is
-         * in our chord*/
-        Note fifth(__INT_MAX__, currentNote.duration(), currentNote.velocity());
-        Note neighboringTone(__INT_MAX__, currentNote.duration(), currentNote.velocity());
-        std::vector<Note> chordTones = currentChord.notes();
-        for(auto it = chordTones.begin(); it < chordTones.end(); ++it) {
-            *it = closestNote(*it, currentNote, dir);
+         * in our chord. Until one is found each counts as infinitely far away and not in between */
+        NoteValue fifth = currentNote, neighboringTone = currentNote;
+        bool foundFifth = false, foundNeighboringTone = false;
+        for(NoteValue tone : currentChord.notes()) {
+            tone = closestNote(tone, currentNote, dir);
             /* The neighboring tone is the closest chord tone to nextNote and in between currentNote
              *  and nextNote if possible */
-            if(((*it - nextNote < neighboringTone - nextNote) ||
-                    (isBetween(*it, currentNote, nextNote) &&
+            if((!foundNeighboringTone || (tone - nextNote < neighboringTone - nextNote) ||
+                    (isBetween(tone, currentNote, nextNote) &&
                     !isBetween(neighboringTone, currentNote, nextNote)))
-                    && it->shortestDistance(nextNote) > 0 &&
-                    it->shortestDistance(currentNote) > 0) {
-                neighboringTone = *it;
+                    && tone.shortestDistance(nextNote) > 0 &&
+                    tone.shortestDistance(currentNote) > 0) {
+                neighboringTone = tone;
+                foundNeighboringTone = true;
             }
-            if((it->number() - nextNote.number() == -5 || it->number() - nextNote.number() == 7) &&
-                it->number() != currentNote.number()) {
-                fifth = *it;
+            if((tone.number() - nextNote.number() == -5 || tone.number() - nextNote.number() == 7) &&
+                tone.number() != currentNote.number()) {
+                fifth = tone;
+                foundFifth = true;
             }
         }
         //// Return the closest leading tone(fifth or neighboringTone) to currentNote
-        return fifth - currentNote < neighboringTone - currentNote ? fifth : neighboringTone;
+        if(!foundNeighboringTone) {
+            return foundFifth ? fifth : nextNote;
+        }
+        return foundFifth && fifth - currentNote < neighboringTone - currentNote ? fifth : neighboringTone;
     }
 
-    /// Returns the closest note within `currentChord`'s voicing in direction `dir`
-    Note closestChordTone(const Note &currentNote, const Chord &currentChord, Direction dir) {
-        std::vector<Note> voicing = currentChord.voicing();
-        Note ret(__INT_MAX__, currentNote.duration(), currentNote.velocity());
-        for(auto it = voicing.begin(); it < voicing.end(); ++it) {
-            *it = closestNote(*it, currentNote, dir);
-            if(*it - currentNote < ret - currentNote && it->number() != currentNote.number()) {
-                ret = *it;
-            }
-        }
-        return ret;
+    /**
+     * Returns the closest note above(`dir` is Up) or below `currentNote` whose pitch class is
+     * `rootPitchClass` plus a pitch class in `neighbours`. Returns `currentNote` if there is none
+     */
+    NoteValue closestChordTone(const NoteValue currentNote, const PitchNeighbours &neighbours,
+            const int rootPitchClass, Direction dir) {
+        int pitchClass = (currentNote.pitchClass() - rootPitchClass + NUM_NOTES) % NUM_NOTES;
+        return currentNote + (dir ? neighbours.up[pitchClass] : -neighbours.down[pitchClass]);
     }
 
-    /// Returns the `n`th closest note within `currentChord` in direction `dir`
-    Note nthClosestChordTone(Note currentNote, const Chord &currentChord, Direction dir, int n) {
+    /**
+     * Returns the closest note within `currentChord`'s voicing in direction `dir`. Returns `currentNote`
+     * if every note of the voicing has the same pitch as it
+     */
+    NoteValue closestChordTone(const NoteValue currentNote, const ChordValue &currentChord, Direction dir) {
+        return closestChordTone(currentNote, makePitchNeighbours(currentChord.voicingMask()), 0, dir);
+    }
+
+    /// Returns the `n`th closest note within `neighbours`(see closestChordTone) in direction `dir`
+    NoteValue nthClosestChordTone(NoteValue currentNote, const PitchNeighbours &neighbours,
+            const int rootPitchClass, Direction dir, int n) {
         while(n-- > 0) {
-            currentNote = closestChordTone(currentNote, currentChord, dir);
+            currentNote = closestChordTone(currentNote, neighbours, rootPitchClass, dir);
         }
         return currentNote;
     }
+
+    /// Returns the `n`th closest note within `currentChord` in direction `dir`
+    NoteValue nthClosestChordTone(NoteValue currentNote, const ChordValue &currentChord, Direction dir, int n) {
+        return nthClosestChordTone(currentNote, makePitchNeighbours(currentChord.voicingMask()), 0, dir, n);
+    }
     
 } // comper
 #endif
@@ -0,0 +1,141 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+#include <memory> // std::shared_ptr
+#include <utility> // std::move
+
+#include "cfgstream.h"
+#include "compiledcfg.h"
+#include "random.h"
+
+CFGStream::CFGStream(std::shared_ptr<const CompiledCFG> grammar, const int steps, Random &random) {
+    restart(grammar, steps, random);
+}
+
+CFGStream::CFGStream(const char *begin, const char *end, std::shared_ptr<const void> owner) {
+    restart(begin, end, std::move(owner));
+}
+
+void CFGStream::restart(const std::shared_ptr<const CompiledCFG> &grammar, const int steps, Random &random) {
+    // Restarting from the same grammar is common, so don't touch the reference counts if we can help it
+    if(_grammar != grammar) {
+        _grammar = grammar;
+    }
+    if(_owner) {
+        _owner = nullptr;
+    }
+    _random = &random;
+    _frames.clear();
+    _walking = _grammar->rightLinear();
+    _position = _end = _leaf = _leafEnd = nullptr;
+    _tail = -1;
+    _chunk = _chunkEnd = nullptr;
+    if(steps > 0) {
+        int alternative = _grammar->pickAlternative(_grammar->start(), *_random);
+        if(_walking) {
+            _enter(alternative, steps - 1);
+        } else {
+            _frames.push_back({_grammar->expansionBegin(alternative), _grammar->expansionEnd(alternative),
+                               steps - 1});
+        }
+    }
+}
+
+void CFGStream::restart(const char *begin, const char *end, std::shared_ptr<const void> owner) {
+    _grammar = nullptr;
+    _owner = std::move(owner);
+    _random = nullptr;
+    _frames.clear();
+    _walking = false;
+    _chunk = begin;
+    _chunkEnd = end;
+}
+
+bool CFGStream::_advance() {
+    if(_walking) {
+        return _walk();
+    }
+    while(!_frames.empty()) {
+        Frame &frame = _frames.back();
+        if(frame.position == frame.end) {
+            _frames.pop_back();
+            continue;
+        }
+        int symbol = *(frame.position++);
+        if(CompiledCFG::isTerminal(symbol)) {
+            int terminal = CompiledCFG::terminalIndex(symbol);
+            _chunk = _grammar->terminalData(terminal);
+            _chunkEnd = _chunk + _grammar->terminalSize(terminal);
+            if(_chunk != _chunkEnd) {
+                return true;
+            }
+        } else if(frame.steps > 0) {
+            // Nonterminals that run out of steps are deleted, otherwise expand them in place
+            int alternative = _grammar->pickAlternative(symbol, *_random);
+            Frame expansion = {_grammar->expansionBegin(alternative), _grammar->expansionEnd(alternative),
+                               frame.steps - 1};
+            // The last symbol of an expansion replaces it
+            if(frame.position == frame.end) {
+                frame = expansion;
+            } else {
+                _frames.push_back(expansion);
+            }
+        }
+    }
+    return false;
+}
+
+bool CFGStream::_walk() {
+    while(true) {
+        int symbol;
+        if(_leaf != _leafEnd) {
+            // Leaves are all terminals
+            symbol = *(_leaf++);
+        } else if(_position != _end) {
+            symbol = *(_position++);
+            if(!CompiledCFG::isTerminal(symbol)) {
+                // Like any other nonterminal a leaf is dropped if it has no steps left
+                if(_steps > 0) {
+                    int alternative = _grammar->pickAlternative(symbol, *_random);
+                    _leaf = _grammar->expansionBegin(alternative);
+                    _leafEnd = _grammar->expansionEnd(alternative);
+                }
+                continue;
+            }
+        } else if(_tail >= 0 && _steps > 0) {
+            _enter(_grammar->pickAlternative(_tail, *_random), _steps - 1);
+            continue;
+        } else {
+            _tail = -1;
+            return false;
+        }
+        int terminal = CompiledCFG::terminalIndex(symbol);
+        _chunk = _grammar->terminalData(terminal);
+        _chunkEnd = _chunk + _grammar->terminalSize(terminal);
+        if(_chunk != _chunkEnd) {
+            return true;
+        }
+    }
+}
+
+void CFGStream::_enter(const int alternative, const int steps) {
+    _tail = _grammar->tail(alternative);
+    _position = _grammar->expansionBegin(alternative);
+    _end = _grammar->expansionEnd(alternative) - (_tail >= 0);
+    _steps = steps;
+}
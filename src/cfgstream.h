@@ -0,0 +1,120 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CFGSTREAM_H
+#define CFGSTREAM_H
+#include <vector>
+#include <memory> // std::shared_ptr
+
+#include "compiledcfg.h"
+#include "random.h"
+
+/**
+ * Pull-based generation from a CompiledCFG. Produces the same strings as generating `steps` steps
+ * up front, but only expands as many nonterminals as are needed for the characters read so far.
+ *
+ * Expansion is depth first with the number of remaining steps stored alongside each partially read
+ * expansion. A nonterminal is expanded if it still has steps left and dropped otherwise, which is
+ * exactly what happens to it when generating breadth first. An expansion whose last symbol is being
+ * expanded is popped first, so right recursive rules run in constant memory and memory in general is
+ * bounded by the depth of the grammar rather than the length of the output.
+ *
+ * A right linear grammar(see CompiledCFG) is walked one state at a time instead, which makes the same
+ * random choices in the same order without touching the frames.
+ */
+class CFGStream {
+public:
+    /// An empty stream. restart() it to read from something
+    CFGStream() = default;
+
+    /**
+     * Stream the string generated by stepping through `grammar` `steps` steps drawing from `random`.
+     * `random` must outlive the stream
+     */
+    CFGStream(std::shared_ptr<const CompiledCFG> grammar, const int steps, Random &random);
+
+    /**
+     * Stream the already generated characters from `begin` up to `end`(for example a string from a
+     * pattern bank). `owner` keeps them alive for as long as we exist
+     */
+    CFGStream(const char *begin, const char *end, std::shared_ptr<const void> owner);
+
+    /**
+     * Stream from `grammar` like the first constructor, dropping whatever we were reading. The memory
+     * we used so far is reused, so restarting a stream doesn't allocate once it has been used for a
+     * while
+     */
+    void restart(const std::shared_ptr<const CompiledCFG> &grammar, const int steps, Random &random);
+
+    /// Stream from `begin` up to `end` like the second constructor, dropping whatever we were reading
+    void restart(const char *begin, const char *end, std::shared_ptr<const void> owner);
+
+    /// Return the next character of the generated string or '\0' if there are no more characters
+    char next() {
+        // Most characters come from a terminal we are already part way through
+        if(_chunk == _chunkEnd && !_advance()) {
+            return '\0';
+        }
+        return *(_chunk++);
+    }
+
+    /// Return true if every character of the generated string has been read
+    bool atEnd() {
+        return _chunk == _chunkEnd && !_advance();
+    }
+
+private:
+    // Expand until we find the next terminal and point _chunk at it. Returns false if there are none
+    bool _advance();
+
+    // _advance() for a right linear grammar
+    bool _walk();
+
+    // Start walking the state expansion `alternative` with `steps` steps left for its symbols
+    void _enter(const int alternative, const int steps);
+
+    // A partially read expansion and the number of steps left for the symbols in it
+    struct Frame {
+        const int *position;
+        const int *end;
+        int steps;
+    };
+
+    std::shared_ptr<const CompiledCFG> _grammar;
+
+    // Keeps the characters of a stream over already generated characters alive
+    std::shared_ptr<const void> _owner;
+
+    // Where our random choices are drawn from
+    Random *_random = nullptr;
+
+    // The expansions we are in the middle of. The innermost one is at the back
+    std::vector<Frame> _frames;
+
+    /* When walking a right linear grammar: the unread symbols of the current state's expansion up to
+     * its tail, the unread symbols of the leaf being read, the tail(or -1) and the steps left for the
+     * symbols of the expansion */
+    bool _walking = false;
+    const int *_position = nullptr, *_end = nullptr, *_leaf = nullptr, *_leafEnd = nullptr;
+    int _tail = -1, _steps = 0;
+
+    // The unread characters of the current terminal
+    const char *_chunk = nullptr;
+    const char *_chunkEnd = nullptr;
+};
+
+#endif // CFGSTREAM_H
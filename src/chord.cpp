@@ -15,47 +15,31 @@ You should have received a copy of the GNU General Public License
 along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+
 #include <string>
 #include <vector>
-#include <regex>
-#include <stdexcept> // std::runtime_error
-#include <algorithm> // std::equal
+#include <array>
 
 #include "chord.h"
+#include "chordsymbol.h"
+#include "chordvalue.h"
 #include "note.h"
-#include "note_numbers.h"
+#include "notevalue.h"
 
 Chord::Chord() {
-    _duration = 0, _velocity = 0, _octave = 4;
-    _voicingNumbers = {1, 3, 5, 7};
-    setName("Cmaj7");
+    _set("Cmaj7", 4, {1, 3, 5, 7}, 0, 0);
 }
 
 Chord::Chord(const std::string name) {
-    _duration = 0, _velocity = 0, _octave = 4;
-    _voicingNumbers = {1, 3, 5, 7};
-    setName(name);
+    _set(name, 4, {1, 3, 5, 7}, 0, 0);
 }
 
 Chord::Chord(const std::string name, const int octave) {
-    _duration = 0, _velocity = 0, _octave = octave;
-    _voicingNumbers = {1, 3, 5, 7};
-    setName(name);
+    _set(name, octave, {1, 3, 5, 7}, 0, 0);
 }
 
 Chord::Chord(const std::string name, const int octave, const std::vector<int> voicing) {
-    _duration = 0, _velocity = 0, _octave = octave;
-    _voicingNumbers = voicing;
-    setName(name);
-}
-
-Chord::Chord(const Chord &chord) {
-    setEqual(chord);
-}
-
-Chord &Chord::operator=(const Chord &chord) {
-    setEqual(chord);
-    return *this;
+    _set(name, octave, voicing, 0, 0);
 }
 
 Chord &Chord::operator=(const std::string name) {
@@ -63,12 +47,8 @@ Chord &Chord::operator=(const std::string name) {
     return *this;
 }
 
-/// @cite https://stackoverflow.com/questions/39855341/equals-operator-on-stl-std::vector-of-pointers
 bool Chord::operator==(const Chord &chord) const {
-    return chord._voicingNumbers == this->_voicingNumbers &&
-        // Dereference each member of `this`._notes std::vector and `chord`._notes std::vector and compare
-            std::equal(begin(this->_notes), end(this->_notes), begin(chord._notes),
-                 [](const Note *a, const Note *b){return *a == *b;});
+    return _value == chord._value;
 }
 
 bool Chord::operator!=(const Chord &chord) const {
@@ -76,121 +56,120 @@ bool Chord::operator!=(const Chord &chord) const {
 }
 
 void Chord::setEqual(const Chord &chord) {
-    this->_name = chord._name;
-    this->_octave = chord._octave;
-    this->_duration = chord._duration;
-    this->_velocity = chord._velocity;
-    this->_voicing = chord._voicing;
-    this->_voicingNumbers = chord._voicingNumbers;
-
-    // Copy each of the notes from `chord` into this chord
-    for(size_t i = 0; i < chord._notes.size(); i++) {
-        *(this->_notes[i]) = *(chord._notes[i]);
-    }
+    *this = chord;
 }
 
 void Chord::setDuration(const int duration) {
-    for(auto it = _notes.begin(); it < _notes.end(); ++it) {
-        (*it)->setDuration(duration);
-    }
-    for(auto it = _voicing.begin(); it < _voicing.end(); ++it) {
-        (it)->setDuration(duration);
-    }
-    _duration = duration;
+    _value = _value.withDuration(duration);
 }
 
 void Chord::setVelocity(const int velocity) {
-    for(auto it = _notes.begin(); it < _notes.end(); ++it) {
-        (*it)->setVelocity(velocity);
-    }
-    for(auto it = _voicing.begin(); it < _voicing.end(); ++it) {
-        (it)->setVelocity(velocity);
-    }
-    _velocity = velocity;
+    _value = _value.withVelocity(velocity);
 }
 
 void Chord::setOctave(const int octave) {
-    for(auto it = _notes.begin(); it < _notes.end(); ++it) {
-        // Add the difference between the target octave and current octave to each note's octave
-        (*it)->setOctave((*it)->octave() + (octave - _octave));
-    }
-    _octave = octave;
-    _setVoicing();
+    _value = _value.withOctave(octave);
 }
 
 void Chord::setName(const std::string name) {
-    _name = name;
-    _checkName();
-    _setTones();
-    _setVoicing();
+    _set(name, octave(), voicingNumbers(), duration(), velocity());
 }
 
 void Chord::setVoicing(const std::vector<int> voicingNumbers) {
-    _voicingNumbers = voicingNumbers;
-    _setVoicing();
+    _value = _value.withVoicing(voicingNumbers);
 }
 
 int Chord::duration() const {
-    return _duration;
+    return _value.duration();
 }
 
 int Chord::velocity() const {
-    return _velocity;
+    return _value.velocity();
 }
 
 int Chord::octave() const {
-    return _octave;
+    return _value.octave();
 }
 
 std::string Chord::name() const {
     return _name;
 }
 
+ChordValue Chord::value() const {
+    return _value;
+}
+
+const ChordSymbol &Chord::symbol() const {
+    return *_symbol;
+}
+
 std::vector<int> Chord::voicingNumbers() const {
-    return _voicingNumbers;
+    std::vector<int> ret;
+    for(size_t i = 0; i < _value.voicingSize(); ++i) {
+        ret.push_back(_value.voicingNumber(i));
+    }
+    return ret;
 }
 
 std::vector<Note> Chord::voicing() const {
-    return _voicing;
+    std::vector<Note> ret;
+    for(size_t i = 0; i < _value.voicingSize(); ++i) {
+        ret.push_back(_note(ChordValue::tone(_value.voicingNumber(i)), _value.voicingValue(i).number()));
+    }
+    return ret;
 }
 
 std::vector<Note> Chord::notes() const {
     std::vector<Note> ret;
-    for(Note *note : _notes) {
-        ret.push_back(*note);
+    for(size_t i = 0; i < 8; ++i) {
+        ret.push_back(_note(i, _value.note(i).number()));
+    }
+    return ret;
+}
+
+std::array<NoteValue, 8> Chord::noteValues() const {
+    return _value.notes();
+}
+
+std::vector<NoteValue> Chord::voicingValues() const {
+    std::vector<NoteValue> ret;
+    ret.reserve(_value.voicingSize());
+    for(size_t i = 0; i < _value.voicingSize(); ++i) {
+        ret.push_back(_value.voicingValue(i));
     }
     return ret;
 }
+
 Note Chord::bass() const {
-    return _bass;
+    return _note(0, _value.note(0).number());
 }
 
 Note Chord::first() const {
-    return _first;
+    return _note(1, _value.note(1).number());
 }
 
 Note Chord::second() const {
-    return _second;
+    return Note(_value.note(2));
 }
 
 Note Chord::third() const {
-    return _third;
+    return Note(_value.note(3));
 }
 
 Note Chord::fourth() const {
-    return _fourth;
+    return Note(_value.note(4));
 }
 
 Note Chord::fifth() const {
-    return _fifth;
+    return Note(_value.note(5));
 }
 
 Note Chord::sixth() const {
-    return _sixth;
+    return Note(_value.note(6));
 }
 
 Note Chord::seventh() const {
-    return _seventh;
+    return Note(_value.note(7));
 }
 
 Note Chord::root() const {
@@ -209,118 +188,18 @@ Note Chord::thirteenth() const {
     return sixth();
 }
 
-void Chord::_setBass() {
-    _bass.setOctave(_octave);
-    _bass.setDuration(_duration);
-    _bass.setVelocity(_velocity);
-    std::regex _bassRegex = std::regex("(^[A-Ga-g](#|b)?)|(/[A-Ga-g](#|b)?)");
-    std::sregex_iterator end;
-    // Augmented and diminished messages are falsely recognized as 'a' and 'd' notes so erase them
-    std::string nameCleaned = std::regex_replace(_name,
-                                       std::regex("((aug)|(Aug)|(dim)|(Dim)|(hdim)|(Hdim)).*"), "");
-    /* Read through all possible bass notes and pick the last one.
-       Ex: The loop for C#/Gb would look like C -> C# -> G -> Gb. Then we pick the Gb */
-    for(std::sregex_iterator it(nameCleaned.begin(), nameCleaned.end(), _bassRegex);
-        it != end; ++it) {
-        // If our bass note is after a slash, remove the slash from the note
-        _bass = (it->str())[0] == '/' ? (it->str()).substr(1) : it->str();
-    }
-}
-
-void Chord::_setFirst() {
-    _first = Note(_name.substr(0, 2), _octave, _duration, _velocity);
-    if(_first < _bass) {
-        _first.setOctave(_bass.octave() + 1);
-    }
-}
-
-void Chord::_setSecond() {
-    int _secondDist = std::regex_search(_name, std::regex("(b9)|(b2)")) ? 1 : 2;
-    _secondDist = std::regex_search(_name, std::regex("(#9)|(#2)")) ? 3 : _secondDist;
-    _second = _first + _secondDist;
-}
-
-void Chord::_setThird() {
-    int _thirdDist = std::regex_search(_name, std::regex("-|~|(^[a-gA-G](#|b)?( )?(/.*)?m(#|b| |[1-9]|(aug)|"
-                                               "\\+)|m$)|^[a-g]|(b3)|(min)|(dim)|(hdim)")) ? 3 : 4;
-    _thirdDist = std::regex_search(_name, std::regex("#3")) ? 5 : _thirdDist;
-    _third = _first + _thirdDist;
-}
-
-void Chord::_setFourth() {
-    int _fourthDist = std::regex_search(_name, std::regex("(b4)|(b11)")) ? 4 : 5;
-    _fourthDist = std::regex_search(_name, std::regex("(#11)|(#4)")) ? 6 : _fourthDist;
-    _fourth = _first + _fourthDist;
-}
-
-void Chord::_setFifth() {
-    int _fifthDist = std::regex_search(_name, std::regex("(b5)|(dim)|(hdim)")) ? 6 : 7;
-    _fifthDist = std::regex_search(_name, std::regex("(#5)|\\+|(aug)")) ? 8 : _fifthDist;
-    _fifth = _first + _fifthDist;
-}
-
-void Chord::_setSixth() {
-    int _sixthDist = std::regex_search(_name, std::regex("(b6)|(b13)")) ? 8 : 9;
-    _sixthDist = std::regex_search(_name, std::regex("(#6)|(#13)")) ? 10 : _sixthDist;
-    _sixth = _first + _sixthDist;
-}
-
-void Chord::_setSeventh() {
-    int _seventhDist = std::regex_search(_name, std::regex("maj|[A-G]#?b?$")) ? 11 : 10;
-    _seventhDist = std::regex_search(_name, std::regex("b7")) ? 10 : _seventhDist;
-    _seventhDist = std::regex_search(_name, std::regex("[a-gA-G](#|b)?( )?(dim)")) ? 9 : _seventhDist;
-    _seventh = _first + _seventhDist;
-}
-
-void Chord::_setTones() {
-    _setBass();
-    _setFirst();
-    _setSecond();
-    _setThird();
-    _setFourth();
-    _setFifth();
-    _setSixth();
-    _setSeventh();
-}
-
-void Chord::_setVoicing() {
-    _voicing = {*(_notes[_voicingNumbers[0]])};
-    for(auto it = _voicingNumbers.begin() + 1; it < _voicingNumbers.end(); ++it) {
-        int index = *it > NUM_DEGREES ? *it % NUM_DEGREES : *it; // Convert 9 to 2, 11 to 4, etc
-        int octave = _voicing.back().octave();
-        _voicing.push_back(*_notes[index]);
-        _voicing.back().setOctave(octave);
-        // If our note is below the previous note in the voicing, bump its octave up
-        if(_voicing.back() <= *(_voicing.rbegin() + 1)) {
-            _voicing.back().setOctave(_voicing.back().octave() + 1);
-        }
-    }
+void Chord::_set(const std::string &name, const int octave, const std::vector<int> &voicingNumbers,
+                 const int duration, const int velocity) {
+    const ChordSymbol &symbol = ChordSymbol::intern(name);
+    _value = ChordValue(symbol, octave, voicingNumbers).withDuration(duration).withVelocity(velocity);
+    _symbol = &symbol;
+    _name = name;
 }
 
-void Chord::_checkName() const {
-    // Make sure we have nothing like C#9(is it C# 9, C #9, or C# #9?)
-    if(std::regex_match(_name, std::regex("[A-Ga-g](#|b)[1-9]"))) {
-        throw std::runtime_error(_name + " contains unclear placement of initial accidental");
-    }
-    // Regex expressions to check each degree
-    std::string validNote("^([a-gA-G](#?|b?)(\\/[a-gA-G](#?b?))?)");
-    std::string validNinth("((b9)|(#9)|(b2)|(#2))");
-    std::string validThird("((m)|(-)|(~)|(dim)|(hdim)|(b3)|(#3)|(min))");
-    std::string validFourth("((b4)|(#4)|(b11)|(#11))");
-    std::string validFifth("((#5)|(\\+)|(b5)|(aug))");
-    std::string validSixth("((b13)|(#13)|(b6)|(#6))");
-    std::string validSeventh("((b7)|(7)|(maj)|(maj7))");
-    std::string space("( )");
-    std::string regexp = ("( )*") + validThird + "?";
-    std::vector<std::string> regexes = {validNinth, validFourth, space,
-                              validFifth, validSixth, validSeventh};
-    // Check one degree at a time
-    for(auto it = regexes.begin(); it < regexes.end(); ++it) {
-        regexp.append("|" + *it);
-    }
-    // Apart from the root, bass, and third, the degrees can appear in any order and any quantity
-    regexp = validNote + "(" + regexp + ")*";
-    if(!std::regex_match(_name, std::regex(regexp))) {
-        throw std::runtime_error(_name + " is an invalid name");
+Note Chord::_note(const size_t tone, const int number) const {
+    if(tone > 1) {
+        return Note(NoteValue(number, duration(), velocity()));
     }
+    return Note(tone == 0 ? _symbol->bass : _symbol->first, _value.spelledOctave(tone, number), duration(),
+                velocity());
 }
@@ -25,6 +25,9 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 #include <stdexcept> // std::runtime_error
 
 #include "note.h"
+#include "notevalue.h"
+#include "chordsymbol.h"
+#include "chordvalue.h"
 
 /**
   * @class Chord
@@ -74,12 +77,6 @@ public:
     /// Sets chord name to `name` octave to `octave` voicing to `voicing`
     Chord(const std::string name, const int octave, const std::vector<int> voicing);
 
-    /// A copy constructor is neccessary because we have a const member(_notes)
-    Chord(const Chord &chord);
-
-    /// Copy assignment is neccessary because we have a const member(_notes)
-    Chord &operator=(const Chord &chord);
-
     /// Sets our chord name to `name` and adjusts notes and voicing accordingly.
     Chord &operator=(const std::string name);
 
@@ -92,10 +89,10 @@ public:
     /// Set this chord's members equal to those of `chord`
     void setEqual(const Chord &chord);
 
-    /// Set our note's duration to `duration`
+    /// Set our note's duration to `duration`. Throws an error if it isn't between 0 and 255
     void setDuration(const int duration);
 
-    /// Set our note's velocity to `velocity`
+    /// Set our note's velocity to `velocity`. Throws an error if it isn't between 0 and 255
     void setVelocity(const int velocity);
 
     /// Sets octave of our chord's bass note to `octave`. Rebuilds the chord if necessary
@@ -106,7 +103,7 @@ public:
 
     /**
      * Sets the voicing of the chord
-     * @param voicingNumbers a vector containing the degrees in our voicing
+     * @param voicingNumbers a vector containing the degrees in our voicing. Up to 8 degrees
      * @example A Cmaj7 chord with {1, 3, 5, 7, 9, 9} would have c, e, g, b, d, d(an octave higher)
      */
     void setVoicing(const std::vector<int> voicingNumbers);
@@ -153,6 +150,12 @@ public:
     /// Return the name of our note
     std::string name() const;
 
+    /// Return our tones and voicing without any names
+    ChordValue value() const;
+
+    /// Return the parsed form of our name
+    const ChordSymbol &symbol() const;
+
     /// Return a vector of ints that represents the degrees in our voicing
     std::vector<int> voicingNumbers() const;
 
@@ -165,6 +168,12 @@ public:
      */
     std::vector<Note> notes() const;
 
+    /// Return notes() without their names
+    std::array<NoteValue, 8> noteValues() const;
+
+    /// Return voicing() without the notes' names
+    std::vector<NoteValue> voicingValues() const;
+
     /// Returns the bass note of the chord. Only different than first() with slash chords
     Note bass() const;
 
@@ -202,46 +211,21 @@ public:
     Note thirteenth() const;
 
 private:
-    // Sets our notes according to the _name. _setBass should be called then _setFirst then the rest
-    void _setBass();
-    void _setFirst();
-    void _setSecond();
-    void _setThird();
-    void _setFourth();
-    void _setFifth();
-    void _setSixth();
-    void _setSeventh();
-
-    // Calls the above 7 functions in order
-    void _setTones();
-
-    // Sets our voicing according to _voicingNumbers
-    void _setVoicing();
-
-    // Raises a runtime_exception if our chord name breaks the specification above
-    void _checkName() const;
-
-    /*
-     * Each note will have a duration and velocity value of _duration and _velocity respectively.
-     * _bass will have the octave _octave and the rest build on top of it
-     */
-    int _duration, _velocity, _octave;
+    // Sets our name to `name` and our tones accordingly
+    void _set(const std::string &name, const int octave, const std::vector<int> &voicingNumbers,
+              const int duration, const int velocity);
+
+    // Return tone `tone`(see ChordValue) at midi number `number`. The bass and root keep their spelling
+    Note _note(const size_t tone, const int number) const;
 
     // The name of our chord. Must be in the form described above
     std::string _name;
 
-    // A series of chord tones indicating the voicing of this chord that will be played.
-    std::vector<int> _voicingNumbers;
-
-    // The notes that comprise our voicing
-    std::vector<Note> _voicing;
-
-    // Note objects representing our chord tones
-    Note _bass, _first, _second, _third, _fourth, _fifth, _sixth, _seventh;
+    // What our name means. Shared with every other chord with the same name
+    const ChordSymbol *_symbol;
 
-    // Allows for easy access of, iteration through, and indexing of the notes of our chord
-    const std::array<Note*, 8> _notes = {&_bass, &_first, &_second, &_third, &_fourth, &_fifth,
-                                       &_sixth, &_seventh};
+    // Our tones, voicing, duration and velocity
+    ChordValue _value;
 };
 
 #endif // CHORD_H
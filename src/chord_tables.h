@@ -0,0 +1,110 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHORD_TABLES_H
+#define CHORD_TABLES_H
+
+#include <cstdint>
+#include <cstddef> // size_t
+#include <vector>
+
+#include "note_numbers.h"
+
+/*
+ * Every chord Chord accepts has a second through seventh that are each a semitone below, at, or a
+ * semitone above their usual distance from the root, so there are 3^6 qualities. A quality is
+ * numbered by reading those choices as the base 3 digits of its number, the second being the lowest
+ */
+const int NUM_QUALITIES = 729;
+
+// The usual distance of the second through seventh from the root. The seventh can be 9, 10, or 11
+constexpr int8_t USUAL_DEGREES[] = {2, 4, 5, 7, 9, 10};
+
+// Return the quality of a chord whose second through seventh are `degrees` semitones above the root
+constexpr int chordQuality(const int8_t *degrees) {
+    int quality = 0;
+    for(int i = 5; i >= 0; --i) {
+        quality = quality * 3 + degrees[i] - USUAL_DEGREES[i] + 1;
+    }
+    return quality;
+}
+
+// The voicings that get a table. Degrees above 7 go up an octave like they do in Chord::setVoicing
+const size_t NUM_VOICINGS = 5;
+const size_t MAX_VOICING_SIZE = 8;
+struct Voicing {
+    int8_t degrees[MAX_VOICING_SIZE];
+    size_t size;
+};
+constexpr Voicing VOICINGS[NUM_VOICINGS] = {{{1, 3, 5, 7}, 4}, {{1, 2, 3, 4, 5, 6, 7}, 7}, {{3, 6, 7, 9}, 4},
+                                            {{7, 9, 3, 5}, 4}, {{1}, 1}};
+
+// The distance of each note of each voicing from the root for every quality
+struct VoicingTables {
+    int8_t offsets[NUM_VOICINGS][NUM_QUALITIES][MAX_VOICING_SIZE];
+};
+
+constexpr VoicingTables makeVoicingTables() {
+    VoicingTables ret = {};
+    for(size_t voicing = 0; voicing < NUM_VOICINGS; ++voicing) {
+        for(int quality = 0; quality < NUM_QUALITIES; ++quality) {
+            // The distance of every degree from the root, indexed like Chord::notes() without the bass
+            int8_t tones[8] = {0, 0};
+            for(int i = 0, digits = quality; i < 6; ++i, digits /= 3) {
+                tones[i + 2] = USUAL_DEGREES[i] + digits % 3 - 1;
+            }
+            const Voicing &degrees = VOICINGS[voicing];
+            int previous = 0;
+            for(size_t i = 0; i < degrees.size; ++i) {
+                int degree = degrees.degrees[i];
+                int tone = tones[degree > NUM_DEGREES ? degree % NUM_DEGREES : degree];
+                // The first note is where it is. Every other one is the lowest with its pitch class above the last
+                if(i > 0) {
+                    tone += (previous - tone) / NUM_NOTES * NUM_NOTES;
+                    while(tone <= previous) {
+                        tone += NUM_NOTES;
+                    }
+                }
+                ret.offsets[voicing][quality][i] = (int8_t)tone;
+                previous = tone;
+            }
+        }
+    }
+    return ret;
+}
+
+constexpr VoicingTables VOICING_TABLES = makeVoicingTables();
+
+// A dominant seventh chord has the usual degrees and voiced 3 6 7 9 on C is E A Bb D
+static_assert(VOICING_TABLES.offsets[2][chordQuality(USUAL_DEGREES)][2] == 10 &&
+              VOICING_TABLES.offsets[2][chordQuality(USUAL_DEGREES)][3] == 14, "The voicing tables are wrong");
+
+// Return the number of `voicingNumbers` in VOICINGS or -1 if it doesn't have a table
+inline int tabledVoicing(const std::vector<int> &voicingNumbers) {
+    for(size_t voicing = 0; voicing < NUM_VOICINGS; ++voicing) {
+        const Voicing &degrees = VOICINGS[voicing];
+        bool same = voicingNumbers.size() == degrees.size;
+        for(size_t i = 0; same && i < degrees.size; ++i) {
+            same = voicingNumbers[i] == degrees.degrees[i];
+        }
+        if(same) {
+            return (int)voicing;
+        }
+    }
+    return -1;
+}
+#endif // CHORD_TABLES_H
@@ -0,0 +1,227 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <algorithm> // std::max
+#include <memory> // std::unique_ptr
+#include <unordered_map>
+#include <mutex> // std::unique_lock
+#include <shared_mutex>
+#include <stdexcept> // std::runtime_error
+
+#include "chordsymbol.h"
+#include "note_numbers.h"
+
+const ChordSymbol &ChordSymbol::intern(const std::string &name) {
+    static std::shared_mutex mutex;
+    static std::unordered_map<std::string, std::unique_ptr<const ChordSymbol>> symbols;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = symbols.find(name);
+        if(it != symbols.end()) {
+            return *it->second;
+        }
+    }
+    // Parse without holding the lock. If another thread beat us to it we keep its record
+    std::unique_ptr<const ChordSymbol> symbol(new ChordSymbol(_parse(name)));
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return *symbols.emplace(name, std::move(symbol)).first->second;
+}
+
+ChordSymbol ChordSymbol::_parse(const std::string &name) {
+    if(name.empty() || !_isLetter(name[0])) {
+        throw std::runtime_error(name + " is an invalid chord name: it must start with a note name");
+    }
+    // Make sure we have nothing like C#9(is it C# 9, C #9, or C# #9?)
+    if(name.size() == 3 && (name[1] == '#' || name[1] == 'b') && name[2] >= '1' && name[2] <= '9') {
+        throw std::runtime_error(name + " contains unclear placement of initial accidental at position 1");
+    }
+    size_t rootEnd = 1 + (name.size() > 1 && (name[1] == '#' || name[1] == 'b'));
+    /* The alterations start after the root or bass and all of its accidentals. An accidental there can also
+     * start an alteration(Cb9 is C b9), but reading it as part of the note name only loses when nothing after
+     * it can be read at all, so the scan backs up into the accidentals then and never rescans otherwise */
+    size_t start = rootEnd, earliest = 1;
+    if(name[rootEnd] == '/') {
+        size_t bass = rootEnd + 1;
+        if(bass >= name.size() || !_isLetter(name[bass])) {
+            throw std::runtime_error(name + " is an invalid chord name: " + (bass < name.size() ?
+                    "unexpected '" + std::string(1, name[bass]) + "'" : std::string("it ends early")) +
+                    " at position " + std::to_string(bass));
+        }
+        earliest = bass + 1;
+        start = earliest + (name.compare(earliest, 2, "#b") == 0 ? 2 :
+                            name[earliest] == '#' || name[earliest] == 'b' ? 1 : 0);
+    }
+    const size_t furthest = start;
+    Alterations alterations;
+    size_t lexed = _lex(name, start, alterations);
+    while(lexed == start && lexed < name.size() && start > earliest) {
+        lexed = _lex(name, --start, alterations);
+    }
+    if(lexed < name.size()) {
+        lexed = std::max(lexed, furthest);
+        throw std::runtime_error(name + " is an invalid chord name: unexpected '" + std::string(1, name[lexed]) +
+                "' at position " + std::to_string(lexed));
+    }
+
+    ChordSymbol symbol;
+    // The bass is whatever follows a slash. Only one accidental is read
+    if(name[rootEnd] == '/') {
+        symbol.bass = name.substr(rootEnd + 1, 1 + (name[rootEnd + 2] == '#' || name[rootEnd + 2] == 'b'));
+    } else {
+        symbol.bass = name.substr(0, rootEnd);
+    }
+    symbol.first = name.substr(0, 2);
+    symbol.bassSpelling = _spelling(symbol.bass);
+    symbol.firstSpelling = _spelling(symbol.first);
+    alterations.flat[3] = alterations.flat[3] || (name[0] >= 'a' && name[0] <= 'g');
+    // The second through sixth are a major scale's unless altered. Sharps win over flats
+    const std::array<int, 8> major = {0, 0, 2, 4, 5, 7, 9, 11};
+    for(int degree = 2; degree < NUM_DEGREES; ++degree) {
+        symbol.degrees[degree - 2] = major[degree] + (alterations.sharp[degree] ? 1 :
+                                                       alterations.flat[degree] ? -1 : 0);
+    }
+    // A name that is only an uppercase root/bass is a major seventh chord
+    size_t end = name.size();
+    end -= end > 0 && name[end - 1] == 'b';
+    end -= end > 0 && name[end - 1] == '#';
+    alterations.major = alterations.major || (end > 0 && name[end - 1] >= 'A' && name[end - 1] <= 'G');
+    symbol.degrees[5] = alterations.diminished ? 9 : alterations.dominant ? 10 : alterations.major ? 11 : 10;
+    int chordTones = 1 << 0, scaleTones = 1 << 0;
+    for(size_t i = 0; i < symbol.degrees.size(); ++i) {
+        // The degrees start from the second so the third, fifth and seventh are every other one
+        chordTones |= (i % 2 == 1) << symbol.degrees[i];
+        scaleTones |= 1 << symbol.degrees[i];
+    }
+    symbol.chordTones = makePitchNeighbours(chordTones);
+    symbol.scaleTones = makePitchNeighbours(scaleTones);
+    return symbol;
+}
+
+size_t ChordSymbol::_lex(const std::string &name, size_t position, Alterations &alterations) {
+    size_t rootEnd = 1 + (name.size() > 1 && (name[1] == '#' || name[1] == 'b'));
+    // Return true if the name continues with `token` at `at`
+    auto startsWith = [&name](const size_t at, const char *token) {
+        return name.compare(at, std::char_traits<char>::length(token), token) == 0;
+    };
+    while(position < name.size()) {
+        switch(name[position]) {
+        case ' ':
+            ++position;
+            break;
+        case '-':
+        case '~':
+            alterations.flat[3] = true;
+            ++position;
+            break;
+        case '+':
+            alterations.sharp[5] = true;
+            ++position;
+            break;
+        case '7':
+            // A 7 right after a root or bass spelled with a b reads as b7
+            alterations.dominant = alterations.dominant || name[position - 1] == 'b';
+            ++position;
+            break;
+        case 'm':
+            if(startsWith(position, "maj")) {
+                alterations.major = true;
+                position += startsWith(position, "maj7") ? 4 : 3;
+            } else if(startsWith(position, "min")) {
+                alterations.flat[3] = true;
+                position += 3;
+            } else {
+                /* A lone m only makes the chord minor at the end of the name or before another
+                 * alteration when it directly follows the root(a space may come between) or the bass */
+                size_t next = position + 1;
+                bool followed = next < name.size() && (name[next] == '#' || name[next] == 'b' ||
+                        name[next] == ' ' || name[next] == '+' || (name[next] >= '1' && name[next] <= '9') ||
+                        startsWith(next, "aug"));
+                bool placed = position == rootEnd || (position == rootEnd + 1 && name[rootEnd] == ' ') ||
+                        name[rootEnd] == '/';
+                alterations.flat[3] = alterations.flat[3] || next == name.size() || (followed && placed);
+                ++position;
+            }
+            break;
+        case 'd': {
+            if(!startsWith(position, "dim")) {
+                return position;
+            }
+            alterations.flat[3] = alterations.flat[5] = true;
+            // dim right after a note name(a space or # may come between) also diminishes the seventh
+            size_t before = position - (name[position - 1] == ' ');
+            alterations.diminished = alterations.diminished || (before > 0 && (_isLetter(name[before - 1]) ||
+                    (name[before - 1] == '#' && before > 1 && _isLetter(name[before - 2]))));
+            position += 3;
+            break;
+        }
+        case 'h':
+            if(!startsWith(position, "hdim")) {
+                return position;
+            }
+            alterations.flat[3] = alterations.flat[5] = true;
+            position += 4;
+            break;
+        case 'a':
+            if(!startsWith(position, "aug")) {
+                return position;
+            }
+            alterations.sharp[5] = true;
+            position += 3;
+            break;
+        case 'b':
+        case '#': {
+            // An accidental followed by a degree. 9, 11, and 13 are the same as 2, 4, and 6
+            int degree = 0;
+            size_t length = 2;
+            if(startsWith(position + 1, "11") || startsWith(position + 1, "13")) {
+                degree = name[position + 2] - '0' + 10;
+                length = 3;
+            } else if(position + 1 < name.size() && name[position + 1] >= '2' && name[position + 1] <= '9' &&
+                      name[position + 1] != '8') {
+                degree = name[position + 1] - '0';
+            }
+            degree = degree > NUM_DEGREES ? degree % NUM_DEGREES : degree;
+            if(degree == 0 || (degree == NUM_DEGREES && name[position] == '#')) {
+                return position;
+            }
+            if(degree == NUM_DEGREES) {
+                alterations.dominant = true;
+            } else if(name[position] == '#') {
+                alterations.sharp[degree] = true;
+            } else {
+                alterations.flat[degree] = true;
+            }
+            position += length;
+            break;
+        }
+        default:
+            return position;
+        }
+    }
+    return position;
+}
+
+bool ChordSymbol::_isLetter(const char c) {
+    return (c >= 'a' && c <= 'g') || (c >= 'A' && c <= 'G');
+}
+
+int ChordSymbol::_spelling(const std::string &name) {
+    // Skip the letter so that we don't count the note 'b' as a flat
+    int spelling = letterNumber(name[0]) + accidentalOffset(name.data() + 1, name.size() - 1);
+    return spelling < 0 ? spelling + NUM_NOTES : spelling;
+}
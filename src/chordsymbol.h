@@ -0,0 +1,82 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHORDSYMBOL_H
+#define CHORDSYMBOL_H
+#include <string>
+#include <array>
+#include <cstddef> // size_t
+
+#include "note_numbers.h"
+
+/**
+ * Everything about a chord that only depends on its name(see Chord for the format): how its bass and
+ * root are spelled and how far above the root each of its other degrees is. Names are only ever parsed
+ * once per process. intern() keeps one immutable record per distinct name in a table shared by every
+ * thread, so building a Chord from a name it has seen before is a hash lookup
+ */
+struct ChordSymbol {
+    /// The spelling of the bass note. The root's unless this is a slash chord
+    std::string bass;
+
+    /// The first two characters of the name, which Chord reads the root from
+    std::string first;
+
+    /**
+     * The pitch classes bass and first are spelled as, read like Note does. From 0(C) to 12, since a B#
+     * is a C in the next octave
+     */
+    int bassSpelling, firstSpelling;
+
+    /// The number of semitones above the root of the second through seventh degrees
+    std::array<int, 6> degrees;
+
+    /**
+     * The neighbours(see note_numbers.h) within our chord tones(1 3 5 7) and scale tones(1 through 7).
+     * Pitch classes are counted up from the root, so 0 is the root whatever it is
+     */
+    PitchNeighbours chordTones, scaleTones;
+
+    /**
+     * Return the record for chord name `name`, parsing it if this is the first time it's been seen.
+     * Throws an error if `name` is invalid. The record lives until the program exits. Thread safe
+     */
+    static const ChordSymbol &intern(const std::string &name);
+
+private:
+    // What the lexer has seen so far. Indexed by degree(1-7)
+    struct Alterations {
+        std::array<bool, 8> flat = {}, sharp = {};
+        // Whether the seventh was marked major, dominant(b7 overrides maj), or diminished(overrides both)
+        bool major = false, dominant = false, diminished = false;
+    };
+
+    // Parse `name` into a new record. Throws an error if it is invalid
+    static ChordSymbol _parse(const std::string &name);
+
+    /* Read the alterations in `name` starting at `position` into `alterations` one token at a time.
+     * Returns name.size() if the rest of the name is valid or the position of the first bad character */
+    static size_t _lex(const std::string &name, size_t position, Alterations &alterations);
+
+    // Return true if `c` can name a note
+    static bool _isLetter(const char c);
+
+    // Return the pitch class the note name `name` is spelled as
+    static int _spelling(const std::string &name);
+};
+
+#endif // CHORDSYMBOL_H
@@ -0,0 +1,286 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHORDVALUE_H
+#define CHORDVALUE_H
+#include <cstdint>
+#include <cstddef> // size_t
+#include <array>
+#include <vector>
+#include <stdexcept> // std::runtime_error
+#include <type_traits> // std::is_trivially_copyable
+
+#include "notevalue.h"
+#include "chordsymbol.h"
+#include "note_numbers.h"
+#include "chord_tables.h"
+
+/**
+ * A chord as a few bytes: its root, how far each of its tones is from the root, a mask of the pitch
+ * classes it contains, and its voicing. It has no name, so it is trivially copyable and copying one
+ * never allocates. Comping works on these and Chord is a named facade over one. Tones are indexed
+ * like Chord::notes(): 0 is the bass, 1 the root, 2 the ninth, etc.
+ *
+ * The bass and root remember how they were spelled so that voicing works exactly like it does with
+ * named notes, where a B# counts as being in the octave below its midi number. Voicings with a table in
+ * chord_tables.h are copied from it instead of being stacked a note at a time
+ */
+class ChordValue {
+public:
+    /// The most degrees a voicing can have
+    static const size_t maxVoicingSize = MAX_VOICING_SIZE;
+
+    ChordValue() = default;
+
+    /// The chord `symbol` names with its bass in octave `octave` voiced with `voicingNumbers`(see Chord)
+    ChordValue(const ChordSymbol &symbol, const int octave, const std::vector<int> &voicingNumbers)
+        : _octave((int8_t)octave), _duration(0), _velocity(0),
+          _bassSpelling((int8_t)symbol.bassSpelling), _rootSpelling((int8_t)symbol.firstSpelling) {
+        int bass = symbol.bassSpelling + NUM_NOTES * (octave - MIDI_START_OCTAVE);
+        int root = symbol.firstSpelling + NUM_NOTES * (octave - MIDI_START_OCTAVE);
+        // The root always goes above the bass
+        if(root < bass) {
+            root += NUM_NOTES;
+        }
+        _root = (int16_t)root;
+        _offsets[0] = (int8_t)(bass - root);
+        _offsets[1] = 0;
+        for(size_t i = 0; i < symbol.degrees.size(); ++i) {
+            _offsets[i + 2] = (int8_t)symbol.degrees[i];
+        }
+        _mask = 0;
+        for(int8_t offset : _offsets) {
+            _mask |= 1 << ((root + offset) % NUM_NOTES);
+        }
+        _setVoicing(voicingNumbers);
+    }
+
+    /// Return the tone with index `tone`
+    NoteValue note(const size_t tone) const {
+        return NoteValue(_root + _offsets[tone], _duration, _velocity);
+    }
+
+    /// Return every tone in index order
+    std::array<NoteValue, 8> notes() const {
+        std::array<NoteValue, 8> ret;
+        for(size_t i = 0; i < ret.size(); ++i) {
+            ret[i] = note(i);
+        }
+        return ret;
+    }
+
+    /// Return the root
+    NoteValue root() const {
+        return note(1);
+    }
+
+    /// Return the bass. Only different from root() with slash chords
+    NoteValue bass() const {
+        return note(0);
+    }
+
+    /// Return a mask with bit p set if one of our tones has pitch class p
+    int mask() const {
+        return _mask;
+    }
+
+    /// Return true if one of our tones has pitch class `pitchClass`
+    bool contains(const int pitchClass) const {
+        return _mask >> pitchClass & 1;
+    }
+
+    /// Return the number of notes in our voicing
+    size_t voicingSize() const {
+        return _voicingSize;
+    }
+
+    /// Return the degree played by note `i` of our voicing
+    int voicingNumber(const size_t i) const {
+        return _voicingNumbers[i];
+    }
+
+    /// Return note `i` of our voicing. The voicing goes from lowest to highest
+    NoteValue voicingValue(const size_t i) const {
+        return NoteValue(_root + _voiced[i], _duration, _velocity);
+    }
+
+    /// Return a mask with bit p set if a note of our voicing has pitch class p
+    int voicingMask() const {
+        int mask = 0;
+        for(size_t i = 0; i < _voicingSize; ++i) {
+            mask |= 1 << (_root + _voiced[i]) % NUM_NOTES;
+        }
+        return mask;
+    }
+
+    /// Return the highest note of our voicing
+    NoteValue top() const {
+        return voicingValue(_voicingSize - 1);
+    }
+
+    /// Return the octave of our bass as Chord sees it
+    int octave() const {
+        return _octave;
+    }
+
+    /// Return our duration
+    int duration() const {
+        return _duration;
+    }
+
+    /// Return our velocity
+    int velocity() const {
+        return _velocity;
+    }
+
+    /// Return the octave tone `tone` is in if its midi number is `number`, going by its spelling
+    int spelledOctave(const size_t tone, const int number) const {
+        return (number - _spelling(tone, number)) / NUM_NOTES + MIDI_START_OCTAVE;
+    }
+
+    /// Return a copy of us voiced with `voicingNumbers`
+    ChordValue withVoicing(const std::vector<int> &voicingNumbers) const {
+        ChordValue ret = *this;
+        ret._setVoicing(voicingNumbers);
+        return ret;
+    }
+
+    /// Return a copy of us moved so that our bass is in octave `octave`
+    ChordValue withOctave(const int octave) const {
+        // The voicing moves along with the rest of the tones so it stays the same distance from the root
+        ChordValue ret = *this;
+        ret._root = (int16_t)(_root + NUM_NOTES * (octave - _octave));
+        ret._octave = (int8_t)octave;
+        return ret;
+    }
+
+    /// Return a copy of us with duration `duration`. Throws an error if it doesn't fit in a byte
+    ChordValue withDuration(const int duration) const {
+        ChordValue ret = *this;
+        ret._duration = (uint8_t)inRange("Duration", duration, 0, UINT8_MAX);
+        return ret;
+    }
+
+    /// Return a copy of us with velocity `velocity`. Throws an error if it doesn't fit in a byte
+    ChordValue withVelocity(const int velocity) const {
+        ChordValue ret = *this;
+        ret._velocity = (uint8_t)inRange("Velocity", velocity, 0, UINT8_MAX);
+        return ret;
+    }
+
+    /// Compares every tone, the voicing, the duration and the velocity
+    bool operator==(const ChordValue &chord) const {
+        if(_voicingSize != chord._voicingSize || _duration != chord._duration ||
+                _velocity != chord._velocity) {
+            return false;
+        }
+        for(size_t i = 0; i < _offsets.size(); ++i) {
+            if(note(i).number() != chord.note(i).number()) {
+                return false;
+            }
+        }
+        for(size_t i = 0; i < _voicingSize; ++i) {
+            if(_voicingNumbers[i] != chord._voicingNumbers[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const ChordValue &chord) const {
+        return !(*this == chord);
+    }
+
+    /// Return the index of the tone that degree `degree` of a voicing plays. 9 is 2, 11 is 4, etc
+    static size_t tone(const int degree) {
+        return degree > NUM_DEGREES ? degree % NUM_DEGREES : degree;
+    }
+
+private:
+    // Return the pitch class tone `tone` is spelled as if its midi number is `number`
+    int _spelling(const size_t tone, const int number) const {
+        return tone == 0 ? _bassSpelling : tone == 1 ? _rootSpelling : number % NUM_NOTES;
+    }
+
+    // Return tone `tone` moved to octave `octave` going by its spelling
+    int _inOctave(const size_t tone, const int octave) const {
+        int number = note(tone).number();
+        return _spelling(tone, number) + NUM_NOTES * (octave - MIDI_START_OCTAVE);
+    }
+
+    // Sets our voicing numbers to `voicingNumbers` and stacks each note of the voicing above the last
+    void _setVoicing(const std::vector<int> &voicingNumbers) {
+        if(voicingNumbers.empty() || voicingNumbers.size() > maxVoicingSize) {
+            throw std::runtime_error("A voicing needs between 1 and 8 notes");
+        }
+        _voicingSize = (uint8_t)voicingNumbers.size();
+        /* Common voicings are looked up. A root spelled B# is in the octave below its midi number, which
+         * the tables don't know about, so voicings of those chords are always worked out */
+        int voicing = tabledVoicing(voicingNumbers);
+        if(voicing >= 0 && _rootSpelling < NUM_NOTES) {
+            const int8_t *offsets = VOICING_TABLES.offsets[voicing][chordQuality(&_offsets[2])];
+            for(size_t i = 0; i < _voicingSize; ++i) {
+                _voicingNumbers[i] = (int8_t)voicingNumbers[i];
+                _voiced[i] = offsets[i];
+            }
+            return;
+        }
+        size_t previousTone = ChordValue::tone(voicingNumbers[0]);
+        int previous = note(previousTone).number();
+        _voicingNumbers[0] = (int8_t)voicingNumbers[0];
+        _voiced[0] = (int8_t)(previous - _root);
+        for(size_t i = 1; i < voicingNumbers.size(); ++i) {
+            size_t next = ChordValue::tone(voicingNumbers[i]);
+            int octave = spelledOctave(previousTone, previous);
+            int number = _inOctave(next, octave);
+            // If our note is below the previous note in the voicing, bump its octave up
+            if(number <= previous) {
+                number = _inOctave(next, octave + 1);
+            }
+            _voicingNumbers[i] = (int8_t)voicingNumbers[i];
+            _voiced[i] = (int8_t)(number - _root);
+            previousTone = next;
+            previous = number;
+        }
+    }
+
+    // The midi number of the root
+    int16_t _root;
+
+    // Bit p is set if one of our tones has pitch class p
+    uint16_t _mask;
+
+    int8_t _octave;
+    uint8_t _duration;
+    uint8_t _velocity;
+
+    // The pitch classes the bass and root are spelled as. See ChordSymbol
+    int8_t _bassSpelling, _rootSpelling;
+
+    uint8_t _voicingSize;
+
+    // The distance of each tone from the root. The bass is never above the root
+    std::array<int8_t, 8> _offsets;
+
+    // The degrees in our voicing and the distance of each note of the voicing from the root
+    std::array<int8_t, maxVoicingSize> _voicingNumbers;
+    std::array<int8_t, maxVoicingSize> _voiced;
+};
+
+static_assert(std::is_trivially_copyable<ChordValue>::value, "ChordValue should be trivially copyable");
+
+#endif // CHORDVALUE_H
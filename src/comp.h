@@ -21,14 +21,20 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 #include <vector>
 #include <string>
 #include <stdexcept> // std::runtime_error
-#include <algorithm> // std::accumulate, std::min
+#include <algorithm> // std::min, std::max
+#include <numeric>   // std::accumulate
 #include <cctype>    // std::isalpha
+#include <cstdlib>   // std::abs
+#include <climits>   // INT_MAX
 
 #include "note.h"
+#include "notevalue.h"
 #include "chord.h"
+#include "chordvalue.h"
 #include "probcfg.h"
 #include "simpleBassline.h" // std::quarterNoteChord
 #include "bassutils.h"      // std::Direction
+#include "random.h"
 
 namespace comper {
     /**
@@ -36,12 +42,10 @@ namespace comper {
      * sequential order. Returns the largest such distance. If one voicing is longer than the other, ignores
      * the notes towards the end of the longer one that don't have a corresponding note in the other chord.
      */
-    int voicingDistance(Chord original, Chord compare) {
-        std::vector<Note> voicing1 = original.voicing();
-        std::vector<Note> voicing2 = compare.voicing();
-        int distance = voicing1[0] - voicing2[0];
-        for(size_t i = 0; i < std::min(voicing1.size(), voicing2.size()); ++i) {
-            distance = voicing1[i] - voicing2[i] > distance ? voicing1[i] - voicing2[i] : distance;
+    int voicingDistance(const ChordValue &original, const ChordValue &compare) {
+        int distance = original.voicingValue(0) - compare.voicingValue(0);
+        for(size_t i = 0; i < std::min(original.voicingSize(), compare.voicingSize()); ++i) {
+            distance = std::max(distance, original.voicingValue(i) - compare.voicingValue(i));
         }
         return distance;
     }
@@ -51,61 +55,152 @@ namespace comper {
      * between top notes of voicing in direction `dir`) where `original` is the chord whose voicing is being
      * altered and `compare` is the chord used to compare to.
      */
-    void voiceLead(Chord &original, const Chord &compare, std::vector<std::vector<int>> voicings, Direction dir) {
+    void voiceLead(ChordValue &original, const ChordValue &compare, const std::vector<std::vector<int>> &voicings,
+            Direction dir) {
         int shortestDistance = 24; // Once we set octave, distance is guaranteed to be less than 24
-        std::vector<int> bestVoicing;
-        int bestOctave = original.octave();
-        for(std::vector<int> voicing : voicings) {
-            original.setVoicing(voicing);
-            Note endOfOriginal = *(original.voicing().rbegin());
-            Note endOfComp = *(compare.voicing().rbegin());
-            Note closest = endOfComp.closest(endOfOriginal.name());
-            original.setOctave(original.octave() + closest.octave() - endOfOriginal.octave());
-            if((original.voicing().rbegin()->number() > compare.voicing().rbegin()->number()) != dir &&
-                    original.voicing().rbegin()->number() != compare.voicing().rbegin()->number()){
-                original.setOctave(dir ? original.octave() + 1 : original.octave() - 1);
+        ChordValue best = original;
+        const NoteValue endOfComp = compare.top();
+        for(const std::vector<int> &voicing : voicings) {
+            original = original.withVoicing(voicing);
+            NoteValue endOfOriginal = original.top();
+            NoteValue closest = endOfComp.closest(endOfOriginal.pitchClass());
+            original = original.withOctave(original.octave() + closest.octave() - endOfOriginal.octave());
+            endOfOriginal = original.top();
+            if((endOfOriginal > endOfComp) != dir && endOfOriginal.number() != endOfComp.number()) {
+                original = original.withOctave(dir ? original.octave() + 1 : original.octave() - 1);
+                endOfOriginal = original.top();
             }
-            if(*(original.voicing().rbegin()) - *(compare.voicing().rbegin()) < shortestDistance){
-                shortestDistance = *(original.voicing().rbegin()) - *(compare.voicing().rbegin());
-                bestVoicing = voicing;
-                bestOctave = original.octave();
+            if(endOfOriginal - endOfComp < shortestDistance){
+                shortestDistance = endOfOriginal - endOfComp;
+                best = original;
             }
         }
-        original.setVoicing(bestVoicing);
-        original.setOctave(bestOctave);
+        original = best;
+    }
+
+    /**
+     * Voices every chord of `progression` with one of `voicings` at once, where `directions[i]` is the way
+     * the top note should move into chord i. Finds the voicing and octave of every chord that minimise:
+     *  - the number of semitones the top note moves from chord to chord, starting from `referenceChord`'s
+     *  - 3 for each chord whose top note moves against its direction
+     *  - 1 for each semitone a top note is more than a fifth away from `referenceChord`'s, so the comping
+     *    doesn't drift away over a long song
+     * Only top notes within an octave of `referenceChord`'s are considered, which leaves a few states for
+     * each voicing of each chord. The cost of every transition depends only on the two top notes, so it
+     * is worked out from them directly and the search takes O(chords x states^2) time. The tables are kept
+     * per thread, so once they have grown big enough nothing is allocated
+     */
+    void voiceLeadProgression(std::vector<ChordValue> &progression, const ChordValue &referenceChord,
+            const std::vector<std::vector<int>> &voicings, const std::vector<Direction> &directions) {
+        if(voicings.empty() || progression.empty()) {
+            return;
+        }
+        const int directionCost = 3, driftCost = 1, freeDrift = 7;
+        const int reference = referenceChord.top().number();
+        // A voicing of one chord in one octave
+        struct State {
+            int top;
+            int voicing;
+            int octave;
+        };
+        /* The states of chord i are states[begin[i]] up to states[begin[i + 1]]. cost[j] is what the cheapest
+         * voicing of the progression up to state j costs and from[j] is the state before j on it */
+        thread_local std::vector<State> states;
+        thread_local std::vector<size_t> begin;
+        thread_local std::vector<int> cost, from;
+        states.clear();
+        begin.assign(1, 0);
+        cost.clear();
+        from.clear();
+        for(size_t i = 0; i < progression.size(); ++i) {
+            for(size_t voicing = 0; voicing < voicings.size(); ++voicing) {
+                const ChordValue voiced = progression[i].withVoicing(voicings[voicing]);
+                const int top = voiced.top().number();
+                // Every octave that puts the top note within an octave of the reference
+                int lowestShift = (reference - NUM_NOTES - top + NUM_NOTES * 64) / NUM_NOTES - 64;
+                for(int shift = lowestShift; top + NUM_NOTES * shift <= reference + NUM_NOTES; ++shift) {
+                    if(top + NUM_NOTES * shift >= reference - NUM_NOTES) {
+                        states.push_back({top + NUM_NOTES * shift, (int)voicing, voiced.octave() + shift});
+                    }
+                }
+            }
+            begin.push_back(states.size());
+            for(size_t j = begin[i]; j < begin[i + 1]; ++j) {
+                int drift = std::max(0, std::abs(states[j].top - reference) - freeDrift) * driftCost;
+                int best = i == 0 ? std::abs(states[j].top - reference) : INT_MAX, bestFrom = -1;
+                for(size_t k = i == 0 ? 0 : begin[i - 1]; i > 0 && k < begin[i]; ++k) {
+                    int move = states[j].top - states[k].top;
+                    int total = cost[k] + std::abs(move) +
+                            (move != 0 && (move > 0) != directions[i]) * directionCost;
+                    if(total < best) {
+                        best = total;
+                        bestFrom = (int)k;
+                    }
+                }
+                cost.push_back(best + drift);
+                from.push_back(bestFrom);
+            }
+        }
+        // Follow the cheapest voicing back from the last chord
+        int state = (int)(std::min_element(cost.begin() + begin[progression.size() - 1], cost.end()) -
+                cost.begin());
+        for(size_t i = progression.size(); i-- > 0; ) {
+            progression[i] = progression[i].withVoicing(voicings[states[state].voicing])
+                    .withOctave(states[state].octave);
+            state = from[state];
+        }
     }
 
     /**
      * Given a progression, a rhythmCFG that produces a rhythm as specified in the README, a directionCFG
      * that produces a direction string as specified in the README, a vector of possible voicings,
-     * a reference note to start voiceleading from, and the velocity, generate a comping pattern and return
-     * it
+     * a reference note to start voiceleading from, a Random to draw every choice from, and the velocity,
+     * generate a comping pattern and return it. Each chord is voice led from the one before it unless
+     * `optimalVoicing` is set, in which case every chord is voiced at once with voiceLeadProgression using
+     * the same directions. Everything but the returned chords is reused from call to call on the same
+     * thread, so once it has grown big enough nothing else is allocated
      */
-    std::vector<Chord> genComping(std::vector<quarterNoteChord> progression, ProbCFG rhythmCFG, 
-            ProbCFG directionCFG, std::vector<std::vector<int>> voicings, Note referenceNote,
-            int velocity = 100) {
-        Chord referenceChord = Chord(referenceNote.name(), referenceNote.octave(), {1});
+    std::vector<ChordValue> genComping(const std::vector<quarterNoteChord> &chords, const ProbCFG &rhythmCFG,
+            const ProbCFG &directionCFG, const std::vector<std::vector<int>> &voicings, const Note referenceNote,
+            Random &random, int velocity = 100, bool optimalVoicing = false) {
+        static const std::vector<int> rootOnly = {1};
+        const ChordValue referenceChord(ChordSymbol::intern(referenceNote.name()), referenceNote.octave(),
+                rootOnly);
+        // Voice lead the values so nothing is allocated as chords are copied around
+        thread_local std::vector<ChordValue> progression;
+        progression.clear();
+        progression.reserve(chords.size());
+        for(const quarterNoteChord &chord : chords) {
+            progression.push_back(chord.value());
+        }
         int totalDuration = std::accumulate(progression.begin(), progression.end(), 0, 
-                [](int total, const quarterNoteChord &chord) {return total + chord.duration();});
-        // Change these 2 so its more efficient(less than totalDuration + 1)
-        std::string rhythm = rhythmCFG.generateString(totalDuration + 1);
-        std::string directions = directionCFG.generateString(totalDuration + 1);
-        int rhythmIndex = 0;
+                [](int total, const ChordValue &chord) {return total + chord.duration();});
+        // Only as much of the rhythm and directions as we read is ever generated
+        thread_local CFGStream rhythm, directions;
+        rhythmCFG.stream(totalDuration + 1, random, rhythm);
+        directionCFG.stream(totalDuration + 1, random, directions);
         int durationSoFarInCurrentChord = 0; // in eighth notes
-        int durationSoFarInProgression = 0; // in quarter notes
-        int directionIndex = 0;
-        std::vector<Chord> ret;
-        for(auto it = progression.begin(); it < progression.end(); ++it) {
-            Direction nextDirection = (Direction)(directions[directionIndex++] == 'U');
-            if(durationSoFarInProgression % 16 == 0) {
-                // reset octave every 4 bars
-                voiceLead(*it, referenceChord, voicings, Down);
-            } else {
-                voiceLead(*it, *(it - 1), voicings, nextDirection);
-            }
-            while(durationSoFarInCurrentChord < it->duration() * 2) { // Convert to eighth notes
+        // The direction into each chord and every chord played as its index, duration and whether it's a rest
+        thread_local std::vector<Direction> chordDirections;
+        chordDirections.clear();
+        chordDirections.reserve(progression.size());
+        struct Hit {
+            size_t chord;
+            int duration;
+            bool rest;
+        };
+        thread_local std::vector<Hit> hits;
+        hits.clear();
+        // At most one chord per eighth note
+        hits.reserve(totalDuration * 2);
+        for(size_t chord = 0; chord < progression.size(); ++chord) {
+            chordDirections.push_back((Direction)(directions.next() == 'U'));
+            while(durationSoFarInCurrentChord < progression[chord].duration() * 2) { // Convert to eighth notes
                 int nextChordDuration;
-                char nextRhythm = rhythm[rhythmIndex++];
+                char nextRhythm = rhythm.next();
+                if(nextRhythm == '\0') {
+                    throw std::runtime_error("The rhythm CFG produced output that was too short");
+                }
                 bool isRest = isalpha(nextRhythm);
                 if(nextRhythm == '4' || nextRhythm == 'q') {
                     nextChordDuration = 4;
@@ -121,17 +216,30 @@ namespace comper {
                     throw std::runtime_error(errorMessage);
                 }
                 durationSoFarInCurrentChord += 8 / nextChordDuration;
-                Chord nextChord = *it;
-                nextChord.setDuration(nextChordDuration);
-                nextChord.setVelocity(isRest ? 0 : velocity);
-                ret.push_back(nextChord);
+                hits.push_back({chord, nextChordDuration, isRest});
             }
-            durationSoFarInCurrentChord =  durationSoFarInCurrentChord - it->duration() * 2 ;
-            durationSoFarInProgression += it->duration();
+            durationSoFarInCurrentChord =  durationSoFarInCurrentChord - progression[chord].duration() * 2 ;
+        }
+        if(optimalVoicing) {
+            voiceLeadProgression(progression, referenceChord, voicings, chordDirections);
+        } else {
+            int durationSoFarInProgression = 0; // in quarter notes
+            for(size_t chord = 0; chord < progression.size(); ++chord) {
+                if(durationSoFarInProgression % 16 == 0) {
+                    // reset octave every 4 bars
+                    voiceLead(progression[chord], referenceChord, voicings, Down);
+                } else {
+                    voiceLead(progression[chord], progression[chord - 1], voicings, chordDirections[chord]);
+                }
+                durationSoFarInProgression += progression[chord].duration();
+            }
+        }
+        std::vector<ChordValue> ret;
+        ret.reserve(hits.size() + 1);
+        for(const Hit &hit : hits) {
+            ret.push_back(progression[hit.chord].withDuration(hit.duration).withVelocity(hit.rest ? 0 : velocity));
         }
-        progression[0].setVelocity(velocity);
-        progression[0].setDuration(1);
-        ret.push_back(progression[0]);
+        ret.push_back(progression[0].withVelocity(velocity).withDuration(1));
         return ret;
     }
 }
@@ -0,0 +1,301 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+#include <string>
+#include <map>
+#include <array>
+#include <memory> // std::shared_ptr
+#include <cstring> // memcpy
+#include <algorithm> // std::fill
+#include <stdexcept> // std::runtime_error
+
+#include "compiledcfg.h"
+#include "weighted_vector.h"
+#include "random.h"
+
+CompiledCFG::CompiledCFG(const std::map<std::string, weightedVector<std::vector<std::string>>> &rules) {
+    // Number the nonterminals first so expansions can refer to rules that come later in the map
+    std::map<std::string, int> nonterminalIds;
+    std::vector<int> nameBegin = {0};
+    std::string nameChars;
+    for(auto it = rules.begin(); it != rules.end(); ++it) {
+        nonterminalIds.emplace(it->first, (int)nameBegin.size() - 1);
+        nameChars += it->first;
+        nameBegin.push_back((int)nameChars.size());
+    }
+    if(nonterminalIds.find("<START>") == nonterminalIds.end()) {
+        throw std::runtime_error("You need a rule with <START> on the left");
+    }
+    std::map<std::string, int> terminalIds;
+    std::vector<int> ruleBegin, totalWeights, weights, expansionBegin = {0}, symbols, terminalBegin = {0};
+    std::string terminalChars;
+    for(auto it = rules.begin(); it != rules.end(); ++it) {
+        ruleBegin.push_back((int)weights.size());
+        totalWeights.push_back(it->second.totalWeight());
+        std::vector<std::vector<std::string>> expansions = it->second.elements();
+        std::vector<int> ruleWeights = it->second.weights();
+        for(size_t i = 0; i < expansions.size(); ++i) {
+            for(const std::string &element : expansions[i]) {
+                if(element.empty()) {
+                    continue;
+                } else if(element[0] == '<') {
+                    auto id = nonterminalIds.find(element);
+                    if(id == nonterminalIds.end()) {
+                        throw std::runtime_error(element + " appears on the right but not the left");
+                    }
+                    symbols.push_back(id->second);
+                } else {
+                    // Intern the terminal the first time we see it
+                    auto id = terminalIds.emplace(element, (int)terminalBegin.size() - 1);
+                    if(id.second) {
+                        terminalChars += element;
+                        terminalBegin.push_back((int)terminalChars.size());
+                    }
+                    symbols.push_back(~id.first->second);
+                }
+            }
+            weights.push_back(ruleWeights[i]);
+            expansionBegin.push_back((int)symbols.size());
+        }
+    }
+    ruleBegin.push_back((int)weights.size());
+    std::vector<long long> aliasThresholds(weights.size());
+    std::vector<int> aliases(weights.size());
+    for(size_t nonterminal = 0; nonterminal + 1 < ruleBegin.size(); ++nonterminal) {
+        int begin = ruleBegin[nonterminal];
+        int count = ruleBegin[nonterminal + 1] - begin;
+        buildAliasTable(&weights[begin], count, totalWeights[nonterminal], &aliasThresholds[begin],
+                &aliases[begin]);
+        // Turn the indices within the rule into alternative indices
+        for(int i = begin; i < begin + count; ++i) {
+            aliases[i] += begin;
+        }
+    }
+    // Lay every table out in one block
+    Header header = {0, nonterminalIds["<START>"], (int)totalWeights.size(), (int)weights.size(),
+                     (int)symbols.size(), (int)terminalBegin.size() - 1, (int)terminalChars.size(),
+                     (int)nameChars.size(), 0, 0};
+    header.size = (int32_t)_layout(header).back();
+    _storage.assign(header.size / sizeof(long long), 0);
+    memcpy(_storage.data(), &header, sizeof(Header));
+    _point((const char *)_storage.data());
+    char *data = (char *)_storage.data();
+    auto copy = [data](const void *table, const void *source, size_t bytes) {
+        memcpy(data + ((const char *)table - data), source, bytes);
+    };
+    copy(_aliasThresholds, aliasThresholds.data(), aliasThresholds.size() * sizeof(long long));
+    copy(_ruleBegin, ruleBegin.data(), ruleBegin.size() * sizeof(int32_t));
+    copy(_totalWeights, totalWeights.data(), totalWeights.size() * sizeof(int32_t));
+    copy(_weights, weights.data(), weights.size() * sizeof(int32_t));
+    copy(_aliases, aliases.data(), aliases.size() * sizeof(int32_t));
+    copy(_expansionBegin, expansionBegin.data(), expansionBegin.size() * sizeof(int32_t));
+    copy(_symbols, symbols.data(), symbols.size() * sizeof(int32_t));
+    copy(_terminalBegin, terminalBegin.data(), terminalBegin.size() * sizeof(int32_t));
+    copy(_nameBegin, nameBegin.data(), nameBegin.size() * sizeof(int32_t));
+    copy(_terminalChars, terminalChars.data(), terminalChars.size());
+    copy(_nameChars, nameChars.data(), nameChars.size());
+    // The tails are worked out from the tables above, so they go in last
+    ((Header *)data)->rightLinear = _findTails((int32_t *)(data + ((const char *)_tails - data)));
+}
+
+CompiledCFG::CompiledCFG(const char *data, const size_t size, std::shared_ptr<const void> owner)
+    : _owner(owner) {
+    const Header *header = (const Header *)data;
+    if(size < sizeof(Header) || (size_t)header->size != size || header->nonterminalCount <= 0 ||
+            header->alternativeCount < 0 || header->symbolCount < 0 || header->terminalCount < 0 ||
+            header->terminalCharCount < 0 || header->nameCharCount < 0 || header->start < 0 ||
+            header->start >= header->nonterminalCount || _layout(*header).back() != size) {
+        throw std::runtime_error("Compiled grammar is corrupt");
+    }
+    _point(data);
+    _check();
+}
+
+std::array<size_t, 13> CompiledCFG::_layout(const Header &header) {
+    size_t alternatives = header.alternativeCount, nonterminals = header.nonterminalCount;
+    // The size of each table in member order
+    std::array<size_t, 12> sizes = {alternatives * sizeof(long long), (nonterminals + 1) * sizeof(int32_t),
+            nonterminals * sizeof(int32_t), alternatives * sizeof(int32_t), alternatives * sizeof(int32_t),
+            alternatives * sizeof(int32_t), (alternatives + 1) * sizeof(int32_t),
+            header.symbolCount * sizeof(int32_t), (header.terminalCount + 1) * sizeof(int32_t),
+            (nonterminals + 1) * sizeof(int32_t), (size_t)header.terminalCharCount, (size_t)header.nameCharCount};
+    std::array<size_t, 13> offsets;
+    offsets[0] = sizeof(Header);
+    for(size_t i = 0; i < sizes.size(); ++i) {
+        offsets[i + 1] = offsets[i] + sizes[i];
+    }
+    // Pad to a multiple of 8 so blocks can be placed back to back
+    offsets.back() = (offsets.back() + sizeof(long long) - 1) / sizeof(long long) * sizeof(long long);
+    return offsets;
+}
+
+void CompiledCFG::_point(const char *data) {
+    _data = data;
+    _header = (const Header *)data;
+    std::array<size_t, 13> offsets = _layout(*_header);
+    _aliasThresholds = (const long long *)(data + offsets[0]);
+    _ruleBegin = (const int32_t *)(data + offsets[1]);
+    _totalWeights = (const int32_t *)(data + offsets[2]);
+    _weights = (const int32_t *)(data + offsets[3]);
+    _aliases = (const int32_t *)(data + offsets[4]);
+    _tails = (const int32_t *)(data + offsets[5]);
+    _expansionBegin = (const int32_t *)(data + offsets[6]);
+    _symbols = (const int32_t *)(data + offsets[7]);
+    _terminalBegin = (const int32_t *)(data + offsets[8]);
+    _nameBegin = (const int32_t *)(data + offsets[9]);
+    _terminalChars = data + offsets[10];
+    _nameChars = data + offsets[11];
+}
+
+void CompiledCFG::_check() const {
+    // Return true if the `count` + 1 elements of `table` go up from 0 to `last`
+    auto ascending = [](const int32_t *table, const int count, const int last) {
+        for(int i = 0; i < count; ++i) {
+            if(table[i + 1] < table[i]) {
+                return false;
+            }
+        }
+        return table[0] == 0 && table[count] == last;
+    };
+    const Header &header = *_header;
+    bool valid = ascending(_ruleBegin, header.nonterminalCount, header.alternativeCount) &&
+            ascending(_expansionBegin, header.alternativeCount, header.symbolCount) &&
+            ascending(_terminalBegin, header.terminalCount, header.terminalCharCount) &&
+            ascending(_nameBegin, header.nonterminalCount, header.nameCharCount);
+    // Every nonterminal needs an alternative to pick, and every pick has to land on one of its own
+    for(int nonterminal = 0; valid && nonterminal < header.nonterminalCount; ++nonterminal) {
+        int begin = _ruleBegin[nonterminal], end = _ruleBegin[nonterminal + 1];
+        long long total = 0;
+        for(int alternative = begin; alternative < end; ++alternative) {
+            valid = valid && _weights[alternative] > 0 && _aliases[alternative] >= begin &&
+                    _aliases[alternative] < end && _aliasThresholds[alternative] >= 0 &&
+                    _aliasThresholds[alternative] <= _totalWeights[nonterminal];
+            total += _weights[alternative];
+        }
+        valid = valid && begin < end && total == _totalWeights[nonterminal];
+    }
+    for(int i = 0; valid && i < header.symbolCount; ++i) {
+        valid = isTerminal(_symbols[i]) ? terminalIndex(_symbols[i]) < header.terminalCount :
+                                          _symbols[i] < header.nonterminalCount;
+    }
+    /* A right linear grammar is walked by reading every nonterminal but the tail as a leaf, so each of those
+     * really has to be one and each tail has to be the last symbol of its alternative */
+    for(int alternative = 0; valid && header.rightLinear && alternative < header.alternativeCount;
+            ++alternative) {
+        const int *begin = expansionBegin(alternative), *end = expansionEnd(alternative);
+        if(_tails[alternative] >= 0) {
+            valid = begin < end && end[-1] == _tails[alternative];
+            --end;
+        } else {
+            valid = _tails[alternative] == -1;
+        }
+        for(const int *it = begin; valid && it < end; ++it) {
+            valid = isTerminal(*it) || _leaf(*it);
+        }
+    }
+    if(!valid) {
+        throw std::runtime_error("Compiled grammar is corrupt");
+    }
+}
+
+bool CompiledCFG::_leaf(const int nonterminal) const {
+    for(const int *it = expansionBegin(alternativesBegin(nonterminal));
+            it < expansionEnd(alternativesEnd(nonterminal) - 1); ++it) {
+        if(!isTerminal(*it)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CompiledCFG::_findTails(int32_t *tails) const {
+    std::vector<bool> leaves(nonterminalCount());
+    for(int nonterminal = 0; nonterminal < nonterminalCount(); ++nonterminal) {
+        leaves[nonterminal] = _leaf(nonterminal);
+    }
+    bool rightLinear = true;
+    for(int alternative = 0; alternative < _header->alternativeCount; ++alternative) {
+        const int *begin = expansionBegin(alternative), *end = expansionEnd(alternative);
+        tails[alternative] = -1;
+        if(begin < end && !isTerminal(end[-1]) && !leaves[end[-1]]) {
+            tails[alternative] = *--end;
+        }
+        for(const int *it = begin; it < end; ++it) {
+            rightLinear = rightLinear && (isTerminal(*it) || leaves[*it]);
+        }
+    }
+    if(!rightLinear) {
+        std::fill(tails, tails + _header->alternativeCount, -1);
+    }
+    return rightLinear;
+}
+
+void CompiledCFG::generate(int steps, Random &random, std::vector<int> &stack, std::string &out) const {
+    if(rightLinear()) {
+        _walk(steps, random, out);
+    } else {
+        expand(steps, random, stack, out);
+    }
+}
+
+void CompiledCFG::_walk(int steps, Random &random, std::string &out) const {
+    // Appends the characters of terminal `symbol`
+    auto append = [this, &out](const int symbol) {
+        out.append(terminalData(terminalIndex(symbol)), terminalSize(terminalIndex(symbol)));
+    };
+    int state = start();
+    while(steps-- > 0 && state >= 0) {
+        int alternative = pickAlternative(state, random);
+        const int *end = expansionEnd(alternative) - (_tails[alternative] >= 0);
+        for(const int *it = expansionBegin(alternative); it < end; ++it) {
+            if(isTerminal(*it)) {
+                append(*it);
+            } else if(steps > 0) {
+                /* A leaf is expanded in the next step, before the tail since it is to the tail's left.
+                 * With no steps left it is dropped along with the tail */
+                int leafAlternative = pickAlternative(*it, random);
+                for(const int *leaf = expansionBegin(leafAlternative); leaf < expansionEnd(leafAlternative);
+                        ++leaf) {
+                    append(*leaf);
+                }
+            }
+        }
+        state = _tails[alternative];
+    }
+}
+
+void CompiledCFG::expand(int steps, Random &random, std::vector<int> &stack, std::string &out) const {
+    // Each entry is a symbol followed by the number of steps it has left. The next symbol is at the back
+    stack.assign({start(), steps});
+    while(!stack.empty()) {
+        int symbolSteps = stack.back();
+        stack.pop_back();
+        int symbol = stack.back();
+        stack.pop_back();
+        if(isTerminal(symbol)) {
+            out.append(terminalData(terminalIndex(symbol)), terminalSize(terminalIndex(symbol)));
+        } else if(symbolSteps > 0) {
+            // Push the expansion backwards so its first symbol comes off the stack first
+            int alternative = pickAlternative(symbol, random);
+            for(const int *it = expansionEnd(alternative); it > expansionBegin(alternative); ) {
+                stack.push_back(*--it);
+                stack.push_back(symbolSteps - 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,276 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef COMPILEDCFG_H
+#define COMPILEDCFG_H
+#include <vector>
+#include <string>
+#include <map>
+#include <array>
+#include <memory> // std::shared_ptr
+#include <cstdint>
+#include <cstddef> // size_t
+
+#include "weighted_vector.h"
+#include "random.h"
+
+/**
+ * Immutable, integer-indexed form of a ProbCFG used for generation.
+ *
+ * Every nonterminal and terminal string is interned to a small integer. A symbol is an int:
+ * nonterminals are numbered from 0 upwards and terminals are stored as ~terminalIndex, so every
+ * terminal symbol is negative. The alternatives of a nonterminal occupy a contiguous range of
+ * alternative indices and the symbols of every alternative occupy a contiguous range of one flat
+ * symbol array, so an expansion is walked by index without touching any strings.
+ * Empty terminals(`) are dropped when compiling since they never contribute any output.
+ * Each nonterminal gets an alias table(see buildAliasTable) so picking an alternative is O(1).
+ *
+ * All of the tables live in one position independent block of memory that data() and size() expose.
+ * That block can be written to disk as is and later used in place(for example from a memory mapped
+ * file) without any parsing or copying.
+ *
+ * Generation is depth first: the symbols waiting to be expanded are kept on a stack along with the
+ * number of steps each has left, and each terminal is written out as soon as it is reached. A
+ * nonterminal with no steps left is dropped, which is exactly what happens to it when every symbol
+ * is rewritten once per step, so the same strings are generated with the same probabilities.
+ *
+ * Most styles are right linear: every alternative is terminals and leaves(nonterminals whose
+ * alternatives are all terminals) followed by at most one nonterminal. Such a grammar is a weighted
+ * finite automaton whose states are its nonterminals, so generate() walks it one state at a time
+ * instead of keeping a stack. The walk makes the same random choices in the same order as the
+ * general expander, so it generates exactly the same strings.
+ */
+class CompiledCFG {
+public:
+    /// Compile `rules` (as returned by ProbCFG::rules()). Every nonterminal must have a rule
+    CompiledCFG(const std::map<std::string, weightedVector<std::vector<std::string>>> &rules);
+
+    /**
+     * Use the `size` bytes at `data`, which must have been produced by data() on a machine with the same
+     * byte order and be 8 byte aligned, in place. `owner` keeps `data` alive for as long as we exist.
+     * Every count and index is checked, so a corrupt or truncated block throws an error instead of being
+     * read out of bounds
+     */
+    CompiledCFG(const char *data, const size_t size, std::shared_ptr<const void> owner);
+
+    // We point into ourselves so we can't be copied
+    CompiledCFG(const CompiledCFG &) = delete;
+    CompiledCFG &operator=(const CompiledCFG &) = delete;
+
+    /// Return the start of the block of memory holding all of our tables
+    const char *data() const {
+        return _data;
+    }
+
+    /// Return the size of the block of memory holding all of our tables in bytes
+    size_t size() const {
+        return _header->size;
+    }
+    /// Return the symbol of the <START> nonterminal
+    int start() const {
+        return _header->start;
+    }
+
+    /// Return the number of distinct nonterminals
+    int nonterminalCount() const {
+        return _header->nonterminalCount;
+    }
+
+    /// Return the number of distinct terminals
+    int terminalCount() const {
+        return _header->terminalCount;
+    }
+
+    /// Return true if `symbol` is a terminal and false if it is a nonterminal
+    static bool isTerminal(const int symbol) {
+        return symbol < 0;
+    }
+
+    /// Return the index of the terminal stored in `symbol`
+    static int terminalIndex(const int symbol) {
+        return ~symbol;
+    }
+
+    /// Return the index of the first alternative of `nonterminal`
+    int alternativesBegin(const int nonterminal) const {
+        return _ruleBegin[nonterminal];
+    }
+
+    /// Return one past the index of the last alternative of `nonterminal`
+    int alternativesEnd(const int nonterminal) const {
+        return _ruleBegin[nonterminal + 1];
+    }
+
+    /// Return the weight of `alternative`
+    int weight(const int alternative) const {
+        return _weights[alternative];
+    }
+
+    /// Return the sum of the weights of every alternative of `nonterminal`
+    int totalWeight(const int nonterminal) const {
+        return _totalWeights[nonterminal];
+    }
+
+    /// Return a pointer to the first symbol of `alternative`
+    const int *expansionBegin(const int alternative) const {
+        return _symbols + _expansionBegin[alternative];
+    }
+
+    /// Return a pointer one past the last symbol of `alternative`
+    const int *expansionEnd(const int alternative) const {
+        return _symbols + _expansionBegin[alternative + 1];
+    }
+
+    /// Return a pointer to the characters of terminal number `terminal`
+    const char *terminalData(const int terminal) const {
+        return _terminalChars + _terminalBegin[terminal];
+    }
+
+    /// Return the number of characters in terminal number `terminal`
+    int terminalSize(const int terminal) const {
+        return _terminalBegin[terminal + 1] - _terminalBegin[terminal];
+    }
+
+    /// Return the name(including the <>) of `nonterminal`
+    std::string nonterminalName(const int nonterminal) const {
+        return std::string(_nameChars + _nameBegin[nonterminal],
+                           _nameBegin[nonterminal + 1] - _nameBegin[nonterminal]);
+    }
+
+    /// Return true if we are right linear(see above) and generate() walks us as an automaton
+    bool rightLinear() const {
+        return _header->rightLinear != 0;
+    }
+
+    /**
+     * Return the nonterminal `alternative` ends with that is expanded after the rest of it, or -1 if it
+     * ends with a terminal or a leaf. Only for a rightLinear() grammar
+     */
+    int tail(const int alternative) const {
+        return _tails[alternative];
+    }
+
+    /**
+     * Pick one of the alternatives of `nonterminal` using a weighted random selection drawn from
+     * `random` in constant time
+     */
+    int pickAlternative(const int nonterminal, Random &random) const {
+        int column = _ruleBegin[nonterminal] +
+                random.bounded(_ruleBegin[nonterminal + 1] - _ruleBegin[nonterminal]);
+        // Worked out without a branch since which way it goes is random
+        int alias = _aliases[column];
+        bool keep = random.bounded(_totalWeights[nonterminal]) < _aliasThresholds[column];
+        return alias + (column - alias) * keep;
+    }
+
+    /**
+     * Step through our rules `steps` times from <START>, replacing every nonterminal with one of its
+     * expansions each step and dropping any that remain, and append the generated string to `out`.
+     * `stack` is used as working space, so nothing is allocated once it and `out` are big enough
+     */
+    void generate(int steps, Random &random, std::vector<int> &stack, std::string &out) const;
+
+    /**
+     * Generate like generate() with the general depth first expander whether or not we are right linear.
+     * This is what generate() does for grammars that aren't. A right linear grammar generates the same
+     * strings from the same draws either way
+     */
+    void expand(int steps, Random &random, std::vector<int> &stack, std::string &out) const;
+
+private:
+    // The counts at the start of every block. The tables follow in the order of the members below
+    struct Header {
+        int32_t size; // in bytes, including this header
+        int32_t start;
+        int32_t nonterminalCount;
+        int32_t alternativeCount;
+        int32_t symbolCount;
+        int32_t terminalCount;
+        int32_t terminalCharCount;
+        int32_t nameCharCount;
+        int32_t rightLinear; // 1 if we are right linear and 0 otherwise
+        int32_t reserved;
+    };
+
+    /* The offset in bytes of each table in a block with `header`'s counts in the order of the members
+     * below. The last element is the size of the whole block */
+    static std::array<size_t, 13> _layout(const Header &header);
+
+    // Point each table into the block at `data` described by its header
+    void _point(const char *data);
+
+    // Throw an error if any of our tables has an index that is out of bounds
+    void _check() const;
+
+    // Return true if every alternative of `nonterminal` is all terminals
+    bool _leaf(const int nonterminal) const;
+
+    /* Return true if we are right linear and fill in `tails`, our _tails table in a block being compiled,
+     * if we are. Done when compiling so a block can be used without working anything out */
+    bool _findTails(int32_t *tails) const;
+
+    // generate() for a right linear grammar
+    void _walk(int steps, Random &random, std::string &out) const;
+
+    // Keeps a block we don't own alive
+    std::shared_ptr<const void> _owner;
+
+    // The block when we own it. long long so that it is 8 byte aligned
+    std::vector<long long> _storage;
+
+    // The start of our block and its header
+    const char *_data;
+    const Header *_header;
+
+    // The alias table of each nonterminal laid out by alternative. _aliases holds alternative indices
+    const long long *_aliasThresholds;
+
+    // _ruleBegin[n] is the first alternative of nonterminal n. Has one extra element at the end
+    const int32_t *_ruleBegin;
+
+    // The total weight of each nonterminal's alternatives
+    const int32_t *_totalWeights;
+
+    // The weight of each alternative
+    const int32_t *_weights;
+
+    const int32_t *_aliases;
+
+    /* _tails[a] is the nonterminal alternative a ends with or -1 if it ends with a terminal or leaf. All -1
+     * unless we are right linear */
+    const int32_t *_tails;
+
+    // _expansionBegin[a] is the index in _symbols of alternative a's first symbol. Has one extra element
+    const int32_t *_expansionBegin;
+
+    // Every alternative's symbols back to back
+    const int32_t *_symbols;
+
+    // _terminalBegin[t] is the index in _terminalChars of terminal t's first character
+    const int32_t *_terminalBegin;
+
+    // _nameBegin[n] is the index in _nameChars of nonterminal n's name. Kept for error messages
+    const int32_t *_nameBegin;
+
+    // Every terminal's characters back to back
+    const char *_terminalChars;
+
+    // Every nonterminal's name back to back
+    const char *_nameChars;
+};
+
+#endif // COMPILEDCFG_H
@@ -0,0 +1,151 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <vector>
+#include <memory> // std::shared_ptr
+#include <fstream>
+#include <cstring> // memcmp, memcpy
+#include <cstdio> // rename
+#include <stdexcept> // std::runtime_error
+
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+#include <unistd.h> // close, write, unlink, getpid
+
+#include "compiledstyle.h"
+#include "compiledcfg.h"
+#include "stylebundle.h"
+
+// Every .stylec file starts with these 8 bytes
+static const char STYLEC_MAGIC[8] = {'C', 'O', 'M', 'P', 'E', 'R', 'S', 'C'};
+
+CompiledStyle::CompiledStyle(const std::string fileName) {
+    int file = open(fileName.c_str(), O_RDONLY);
+    if(file < 0) {
+        throw std::runtime_error("File " + fileName + " not found");
+    }
+    struct stat status;
+    void *mapping = MAP_FAILED;
+    if(fstat(file, &status) == 0 && status.st_size > 0) {
+        mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    }
+    close(file); // The mapping stays valid after the file is closed
+    if(mapping == MAP_FAILED) {
+        throw std::runtime_error("Could not map " + fileName + " into memory");
+    }
+    _size = status.st_size;
+    _data = (const char *)mapping;
+    size_t size = _size;
+    _mapping = std::shared_ptr<const void>(mapping, [size](const void *data) {
+        munmap(const_cast<void *>(data), size);
+    });
+    const FileHeader *header = (const FileHeader *)_data;
+    if(_size < sizeof(FileHeader) || memcmp(header->magic, STYLEC_MAGIC, sizeof(STYLEC_MAGIC)) != 0) {
+        throw std::runtime_error(fileName + " is not a compiled style file");
+    } else if(header->version != _version || header->byteOrderMark != _byteOrderMark) {
+        throw std::runtime_error(fileName + " was compiled by an incompatible version of comper");
+    } else if(_size < sizeof(FileHeader) + header->sectionCount * sizeof(SectionEntry)) {
+        throw std::runtime_error(fileName + " is corrupt");
+    }
+    for(int i = 0; i < sectionCount(); ++i) {
+        const SectionEntry &entry = _entry(i);
+        if((size_t)entry.nameOffset + entry.nameSize > _size ||
+                (size_t)entry.grammarOffset + entry.grammarSize > _size || entry.grammarOffset % 8 != 0) {
+            throw std::runtime_error(fileName + " is corrupt");
+        }
+    }
+}
+
+void CompiledStyle::write(const StyleBundle &style, const std::string fileName) {
+    std::vector<std::string> names = style.names();
+    FileHeader header;
+    memcpy(header.magic, STYLEC_MAGIC, sizeof(STYLEC_MAGIC));
+    header.version = _version;
+    header.byteOrderMark = _byteOrderMark;
+    header.sectionCount = names.size();
+    header.reserved = 0;
+    // Lay out the names right after the entries and then each block on an 8 byte boundary
+    std::vector<SectionEntry> entries(names.size());
+    size_t offset = sizeof(FileHeader) + names.size() * sizeof(SectionEntry);
+    for(size_t i = 0; i < names.size(); ++i) {
+        entries[i].nameOffset = offset;
+        entries[i].nameSize = names[i].size();
+        offset += names[i].size();
+    }
+    std::vector<std::shared_ptr<const CompiledCFG>> grammars;
+    for(size_t i = 0; i < names.size(); ++i) {
+        grammars.push_back(style.cfg(names[i])->compiled());
+        offset = (offset + 7) / 8 * 8;
+        entries[i].grammarOffset = offset;
+        entries[i].grammarSize = grammars[i]->size();
+        offset += grammars[i]->size();
+    }
+    std::string contents((const char *)&header, sizeof(header));
+    contents.append((const char *)entries.data(), entries.size() * sizeof(SectionEntry));
+    for(const std::string &name : names) {
+        contents += name;
+    }
+    for(size_t i = 0; i < grammars.size(); ++i) {
+        // Pad up to the block's offset
+        contents.resize(entries[i].grammarOffset, '\0');
+        contents.append(grammars[i]->data(), grammars[i]->size());
+    }
+    /* Anything that has the old file mapped keeps reading it as it was, so write a new file next to it and
+     * move that into place instead of rewriting it */
+    std::string temporaryName = fileName + ".tmp" + std::to_string(getpid());
+    int file = open(temporaryName.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+    if(file < 0) {
+        throw std::runtime_error("Could not open " + temporaryName + " for writing");
+    }
+    size_t written = 0;
+    while(written < contents.size()) {
+        ssize_t size = ::write(file, contents.data() + written, contents.size() - written);
+        if(size <= 0) {
+            break;
+        }
+        written += size;
+    }
+    if(close(file) != 0 || written < contents.size() || rename(temporaryName.c_str(), fileName.c_str()) != 0) {
+        unlink(temporaryName.c_str());
+        throw std::runtime_error("Could not write " + fileName);
+    }
+}
+
+bool CompiledStyle::isCompiledStyle(const std::string fileName) {
+    std::ifstream file(fileName, std::ios::binary);
+    char magic[sizeof(STYLEC_MAGIC)];
+    return file.read(magic, sizeof(magic)) && memcmp(magic, STYLEC_MAGIC, sizeof(magic)) == 0;
+}
+
+int CompiledStyle::sectionCount() const {
+    return ((const FileHeader *)_data)->sectionCount;
+}
+
+std::string CompiledStyle::sectionName(const int section) const {
+    return std::string(_data + _entry(section).nameOffset, _entry(section).nameSize);
+}
+
+std::shared_ptr<const CompiledCFG> CompiledStyle::section(const int section) const {
+    return std::make_shared<const CompiledCFG>(_data + _entry(section).grammarOffset,
+                                               _entry(section).grammarSize, _mapping);
+}
+
+const CompiledStyle::SectionEntry &CompiledStyle::_entry(const int section) const {
+    return ((const SectionEntry *)(_data + sizeof(FileHeader)))[section];
+}
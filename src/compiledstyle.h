@@ -0,0 +1,93 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef COMPILEDSTYLE_H
+#define COMPILEDSTYLE_H
+#include <string>
+#include <memory> // std::shared_ptr
+#include <cstdint>
+#include <cstddef> // size_t
+
+#include "compiledcfg.h"
+#include "stylebundle.h"
+
+/**
+ * A precompiled style file(.stylec) mapped into memory.
+ *
+ * A .stylec file holds every section of a style file as a CompiledCFG block(interned rule tables,
+ * weights and alias tables) so it can be used without any parsing. Every offset is relative to the
+ * start of the file so the file can be mapped anywhere. The layout is:
+ * - A FileHeader holding the magic number, format version, a byte order mark and the section count
+ * - One SectionEntry per section giving the offset and size of its name and of its CompiledCFG block
+ * - The section names back to back
+ * - Each CompiledCFG block starting on an 8 byte boundary
+ * Files are only readable by builds with the same format version and byte order.
+ */
+class CompiledStyle {
+public:
+    /// Map `fileName` into memory. Throws an error if it isn't a .stylec file we can read
+    CompiledStyle(const std::string fileName);
+
+    /**
+     * Write every section of `style` to `fileName` as a .stylec file. The file is written next to
+     * `fileName` and then renamed over it, so anything that has the old file mapped keeps its version
+     */
+    static void write(const StyleBundle &style, const std::string fileName);
+
+    /// Return true if `fileName` starts like a .stylec file
+    static bool isCompiledStyle(const std::string fileName);
+
+    /// Return the number of sections in our file
+    int sectionCount() const;
+
+    /// Return the name of section number `section`
+    std::string sectionName(const int section) const;
+
+    /// Return the CFG of section number `section`. It points into our mapping and keeps it alive
+    std::shared_ptr<const CompiledCFG> section(const int section) const;
+
+private:
+    static const uint32_t _version = 2;
+    static const uint32_t _byteOrderMark = 0x01020304;
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t byteOrderMark;
+        uint32_t sectionCount;
+        uint32_t reserved;
+    };
+
+    struct SectionEntry {
+        uint32_t nameOffset;
+        uint32_t nameSize;
+        uint32_t grammarOffset;
+        uint32_t grammarSize;
+    };
+
+    // Return section number `section`'s entry
+    const SectionEntry &_entry(const int section) const;
+
+    // Unmaps the file once we and every CFG pointing into it are gone
+    std::shared_ptr<const void> _mapping;
+
+    // The mapped file and its size in bytes
+    const char *_data;
+    size_t _size;
+};
+
+#endif // COMPILEDSTYLE_H
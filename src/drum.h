@@ -22,15 +22,17 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 #include "note_numbers.h"
 
 #include "probcfg.h"
+#include "notevalue.h"
 #include "midiwriter.h"
 namespace comper {
-    std::vector<Note> addSimpleDrumSwingPattern(const int measureCount, const int velocity = 100) {
-        std::vector<Note> pattern;
+    std::vector<NoteValue> addSimpleDrumSwingPattern(const int measureCount, const int velocity = 100) {
+        std::vector<NoteValue> pattern;
+        pattern.reserve(measureCount * 6);
         for(int i = 0; i < measureCount * 2; ++i) {
             int crashCymbal = 51;
-            pattern.push_back(Note(crashCymbal, 4, velocity));
-            pattern.push_back(Note(crashCymbal, 8, velocity));
-            pattern.push_back(Note(crashCymbal, 8, velocity));
+            pattern.push_back(NoteValue(crashCymbal, 4, velocity));
+            pattern.push_back(NoteValue(crashCymbal, 8, velocity));
+            pattern.push_back(NoteValue(crashCymbal, 8, velocity));
         }
         return pattern;
     }
@@ -0,0 +1,107 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+#include <array>
+#include <algorithm> // std::min, std::max
+#include <stdexcept> // std::runtime_error
+
+#include "lengthbounds.h"
+#include "compiledcfg.h"
+
+// Every character has length 1
+std::array<int, 256> unitLengths() {
+    std::array<int, 256> ret;
+    ret.fill(1);
+    return ret;
+}
+
+LengthBounds::LengthBounds(const CompiledCFG &grammar, const int maxSteps)
+    : LengthBounds(grammar, maxSteps, unitLengths()) {}
+
+LengthBounds::LengthBounds(const CompiledCFG &grammar, const int maxSteps,
+                           const std::array<int, 256> &characterLengths) {
+    if(maxSteps < 0) {
+        throw std::runtime_error("maxSteps cannot be negative");
+    }
+    _start = grammar.start();
+    _nonterminalCount = grammar.nonterminalCount();
+    _maxSteps = maxSteps;
+    std::vector<long long> terminalLengths(grammar.terminalCount());
+    for(int terminal = 0; terminal < grammar.terminalCount(); ++terminal) {
+        const char *data = grammar.terminalData(terminal);
+        for(int i = 0; i < grammar.terminalSize(terminal); ++i) {
+            terminalLengths[terminal] += characterLengths[(unsigned char)data[i]];
+        }
+    }
+    // Nothing is generated in 0 steps
+    _minimum.assign((size_t)(maxSteps + 1) * _nonterminalCount, 0);
+    _maximum.assign((size_t)(maxSteps + 1) * _nonterminalCount, 0);
+    for(int steps = 1; steps <= maxSteps; ++steps) {
+        const long long *previousMinimum = &_minimum[(size_t)(steps - 1) * _nonterminalCount];
+        const long long *previousMaximum = &_maximum[(size_t)(steps - 1) * _nonterminalCount];
+        for(int nonterminal = 0; nonterminal < _nonterminalCount; ++nonterminal) {
+            long long shortest = unbounded, longest = 0;
+            for(int alternative = grammar.alternativesBegin(nonterminal);
+                    alternative < grammar.alternativesEnd(nonterminal); ++alternative) {
+                long long shortestAlternative = 0, longestAlternative = 0;
+                for(const int *symbol = grammar.expansionBegin(alternative);
+                        symbol < grammar.expansionEnd(alternative); ++symbol) {
+                    if(CompiledCFG::isTerminal(*symbol)) {
+                        shortestAlternative += terminalLengths[CompiledCFG::terminalIndex(*symbol)];
+                        longestAlternative += terminalLengths[CompiledCFG::terminalIndex(*symbol)];
+                    } else {
+                        shortestAlternative += previousMinimum[*symbol];
+                        longestAlternative += previousMaximum[*symbol];
+                    }
+                    shortestAlternative = std::min(shortestAlternative, unbounded);
+                    longestAlternative = std::min(longestAlternative, unbounded);
+                }
+                shortest = std::min(shortest, shortestAlternative);
+                longest = std::max(longest, longestAlternative);
+            }
+            _minimum[(size_t)steps * _nonterminalCount + nonterminal] = shortest;
+            _maximum[(size_t)steps * _nonterminalCount + nonterminal] = longest;
+        }
+    }
+}
+
+int LengthBounds::maxSteps() const {
+    return _maxSteps;
+}
+
+long long LengthBounds::minimum(const int steps) const {
+    return minimum(_start, steps);
+}
+
+long long LengthBounds::maximum(const int steps) const {
+    return maximum(_start, steps);
+}
+
+long long LengthBounds::minimum(const int nonterminal, const int steps) const {
+    if(steps < 0 || steps > _maxSteps) {
+        throw std::runtime_error("No bounds were found for " + std::to_string(steps) + " steps");
+    }
+    return _minimum[(size_t)steps * _nonterminalCount + nonterminal];
+}
+
+long long LengthBounds::maximum(const int nonterminal, const int steps) const {
+    if(steps < 0 || steps > _maxSteps) {
+        throw std::runtime_error("No bounds were found for " + std::to_string(steps) + " steps");
+    }
+    return _maximum[(size_t)steps * _nonterminalCount + nonterminal];
+}
@@ -0,0 +1,72 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef LENGTHBOUNDS_H
+#define LENGTHBOUNDS_H
+#include <vector>
+#include <array>
+
+#include "compiledcfg.h"
+
+/**
+ * The shortest and longest output each nonterminal of a CompiledCFG can generate in 0 to maxSteps
+ * steps, found without generating anything.
+ *
+ * A nonterminal with 0 steps left is deleted so it generates nothing. Otherwise its bounds after n
+ * steps are the smallest/largest over its alternatives of the sum of the lengths of the alternative's
+ * terminals and the bounds of its nonterminals after n - 1 steps. Filling in this table step by step
+ * takes O(maxSteps * number of symbols in the grammar).
+ *
+ * The length of a terminal is normally its number of characters but each character can be given its own
+ * length, for example to measure a rhythm in eighth notes. Maximums that don't fit are capped at
+ * LengthBounds::unbounded.
+ */
+class LengthBounds {
+public:
+    /// Anything at least this long is considered too long to count
+    static constexpr long long unbounded = 1LL << 60;
+
+    /// Find the bounds of every nonterminal of `grammar` for up to `maxSteps` steps
+    LengthBounds(const CompiledCFG &grammar, const int maxSteps);
+
+    /// Find the bounds of every nonterminal where character c has length `characterLengths[c]`
+    LengthBounds(const CompiledCFG &grammar, const int maxSteps, const std::array<int, 256> &characterLengths);
+
+    /// Return the largest number of steps we have bounds for
+    int maxSteps() const;
+
+    /// Return the shortest output <START> can generate in `steps` steps
+    long long minimum(const int steps) const;
+
+    /// Return the longest output <START> can generate in `steps` steps
+    long long maximum(const int steps) const;
+
+    /// Return the shortest output `nonterminal` can generate in `steps` steps
+    long long minimum(const int nonterminal, const int steps) const;
+
+    /// Return the longest output `nonterminal` can generate in `steps` steps
+    long long maximum(const int nonterminal, const int steps) const;
+
+private:
+    int _start, _nonterminalCount, _maxSteps;
+
+    // The bounds after n steps of nonterminal t are at index n * _nonterminalCount + t
+    std::vector<long long> _minimum;
+    std::vector<long long> _maximum;
+};
+
+#endif // LENGTHBOUNDS_H
@@ -16,67 +16,151 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include <cstdlib>
+#include <cstdint>
 #include <iostream> // std::cout, fstream
 #include <fstream>
 #include <string>
 #include <vector>
+#include <thread> // std::thread::hardware_concurrency
+#include <algorithm> // std::max
 
 #include "drum.h"
 #include "comp.h"
 #include "probcfg.h"
 #include "simpleBassline.h"
-#include "bassutils.h" // comper::quarterNoteChord
-#include "probcfg.h"
+#include "walkingbass.h"
+#include "optimalbass.h"
+#include "bassutils.h"
+#include "progression.h" // comper::readProgression
+#include "stylebundle.h"
+#include "compiledstyle.h"
+#include "stylecontract.h"
+#include "prefixdistribution.h"
 #include "midiwriter.h"
+#include "random.h"
 
 int main(int argc, char *argv[]) {
-    if(argc != 6) {
-        std::cout << "usage: comper <progression file> <style file> <output file> <bpm> <repetitions>" << std::endl;
+    // Pull the options out and leave the positional arguments in order
+    std::vector<std::string> arguments;
+    bool seeded = false;
+    uint64_t seed = 0;
+    bool compileStyle = false;
+    bool patternBanks = false;
+    bool analyzeStyle = false;
+    bool optimalBass = false;
+    bool optimalComping = false;
+    for(int i = 1; i < argc; ++i) {
+        if(std::string(argv[i]) == "--seed" && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+            seeded = true;
+        } else if(std::string(argv[i]) == "--compile-style") {
+            compileStyle = true;
+        } else if(std::string(argv[i]) == "--analyze-style") {
+            analyzeStyle = true;
+        } else if(std::string(argv[i]) == "--pattern-banks") {
+            patternBanks = true;
+        } else if(std::string(argv[i]) == "--optimal-bass") {
+            optimalBass = true;
+        } else if(std::string(argv[i]) == "--optimal-comping") {
+            optimalComping = true;
+        } else {
+            arguments.push_back(argv[i]);
+        }
+    }
+    if(compileStyle && arguments.size() == 2) {
+        StyleBundle style;
+        style.fromFile(arguments[0]);
+        comper::checkStyleContract(style, comper::defaultContractSteps);
+        CompiledStyle::write(style, arguments[1]);
+        return 0;
+    } else if(analyzeStyle && arguments.size() == 3) {
+        StyleBundle style;
+        style.fromFile(arguments[0]);
+        int steps = std::strtol(arguments[1].c_str(), nullptr, 10);
+        int prefixLength = std::strtol(arguments[2].c_str(), nullptr, 10);
+        Random random = seeded ? Random(seed) : Random();
+        int threads = std::max(1u, std::thread::hardware_concurrency());
+        const size_t shown = 20;
+        for(std::string name : style.names()) {
+            PrefixDistribution distribution(style[name], steps, prefixLength, random, 200000, threads);
+            std::cout << "[" << name << "] after " << steps << " steps: expected length "
+                      << distribution.expectedLength() << ", "
+                      << (distribution.exact() ? std::string("exact") : "estimated from " +
+                          std::to_string(distribution.samples()) + " strings") << std::endl;
+            const std::vector<PrefixDistribution::Outcome> &outcomes = distribution.outcomes();
+            for(size_t i = 0; i < outcomes.size() && i < shown; ++i) {
+                std::cout << "    " << outcomes[i].prefix << "    " << outcomes[i].probability;
+                if(!distribution.exact()) {
+                    std::cout << " +- " << outcomes[i].margin;
+                }
+                std::cout << std::endl;
+            }
+            if(outcomes.size() > shown) {
+                std::cout << "    ... and " << outcomes.size() - shown << " more" << std::endl;
+            }
+        }
+        return 0;
+    } else if(compileStyle || analyzeStyle || arguments.size() != 5) {
+        std::cout << "usage: comper [--seed <seed>] [--pattern-banks] [--optimal-bass] [--optimal-comping] "
+                     "<progression file> <style file> <output file> <bpm> <repetitions>" << std::endl;
+        std::cout << "       comper --compile-style <style file> <output file>" << std::endl;
+        std::cout << "       comper --analyze-style [--seed <seed>] <style file> <steps> <prefix length>" << std::endl;
         return 1;
     }
+    if(!seeded) {
+        seed = Random().generate64();
+        std::cout << "Using seed " << seed << std::endl;
+    }
     int velocity = 100;
-    std::vector<comper::quarterNoteChord> progression;
-    int repetitions = std::strtol(argv[5], nullptr, 10);
+    int repetitions = std::strtol(arguments[4].c_str(), nullptr, 10);
+    if(!std::ifstream(arguments[0]).is_open()) {
+        std::cout << "Illegal filename";
+        return 1;
+    }
+    std::vector<comper::quarterNoteChord> progression = comper::readProgression(arguments[0], repetitions,
+                                                                               velocity);
     int totalDuration = 0;
-    for(int i = 0; i < repetitions; ++i) {
-        std::ifstream progressionFile(argv[1]);
-        if(progressionFile.is_open()) {
-            std::string line;
-            while(getline(progressionFile, line)) {
-                std::string chordName = line.substr(0, line.find_last_of(' '));
-                int duration = strtol(line.substr(line.find_last_of(' ') + 1).c_str(), nullptr, 10);
-                Chord nextChord = comper::quarterNoteChord(chordName);
-                nextChord.setDuration(duration);
-                totalDuration += duration;
-                nextChord.setVelocity(velocity);
-                progression.push_back(nextChord);
+    for(const comper::quarterNoteChord &chord : progression) {
+        totalDuration += chord.duration();
+    }
+    int bpm = std::strtol(arguments[3].c_str(), nullptr, 10);
+    std::string cfgFile = arguments[1];
+    MidiWriter writer(bpm, 2.0/3.0);
+    StyleBundle style;
+    style.fromFile(cfgFile);
+    // Reject a style that could run out partway through the song before generating anything
+    comper::checkStyleContract(style, totalDuration + 1);
+    if(patternBanks) {
+        // Draw the bass patterns for the usual chord lengths from banks made up front on every core
+        Random bankRandom(seed, 2);
+        int threads = std::max(1u, std::thread::hardware_concurrency());
+        for(std::string name : {"bassPattern", "bassDirection"}) {
+            style.buildBanks(name, {2, 4, 8}, 4096, bankRandom, threads);
+            for(int steps : {2, 4, 8}) {
+                BankStatistics statistics = style[name].checkBank(steps, 4096, bankRandom, threads);
+                std::cout << "Bank [" << name << "] for " << steps << " steps: " << statistics.outcomes
+                          << " patterns, distance " << statistics.distance << " (tolerance "
+                          << statistics.tolerance << "), per character distance "
+                          << statistics.characterDistance << " (tolerance " << statistics.characterTolerance
+                          << ")" << std::endl;
             }
         }
-        else {
-            std::cout << "Illegal filename";
-            return 1;
-        }
     }
-    int bpm = std::strtol(argv[4], nullptr, 10);
-    std::string cfgFile = std::string(argv[2]);
-    MidiWriter writer(bpm, 2.0/3.0);
-    ProbCFG bassPatternCFG;
-    bassPatternCFG.fromFile(cfgFile, "bassPattern");
-    ProbCFG bassDirectionCFG;
-    bassDirectionCFG.fromFile(cfgFile, "bassDirection");
+    // Bass and comping get their own streams so the same seed always gives the same track
+    Random bassRandom(seed, 0);
+    Random compingRandom(seed, 1);
     int bassInstrumentNumber = 34;
-    writer.addNotes(comper::genSimpleWalkingBassline(progression, bassPatternCFG, bassDirectionCFG,
-                Note("C", 3), Note("G", 3)), bassInstrumentNumber);
-    ProbCFG compingRhythmCFG;
-    compingRhythmCFG.fromFile(cfgFile, "compingRhythm");
-    ProbCFG compingDirectionCFG;
-    compingDirectionCFG.fromFile(cfgFile, "compingDirection");
+    // The optimal bassline plans the whole song instead of turning around whenever it goes out of range
+    auto genBassline = optimalBass ? comper::genOptimalWalkingBassline : comper::genWalkingBassline;
+    writer.addNotes(genBassline(progression, style["bassPattern"], style["bassDirection"], Note("C", 3),
+                Note("G", 3), bassRandom, velocity), bassInstrumentNumber);
     std::vector<std::vector<int>> voicings = {{3, 6, 7, 9}, {7, 9, 3, 5}};
     int chordInstrumentNumber = 1;
-    writer.addChords(comper::genComping(progression, compingRhythmCFG, compingDirectionCFG, voicings,
-                Note("G", 5), velocity), chordInstrumentNumber);
+    // The optimal comping voices the whole song at once instead of voice leading chord by chord
+    writer.addChords(comper::genComping(progression, style["compingRhythm"], style["compingDirection"],
+                voicings, Note("G", 5), compingRandom, velocity, optimalComping), chordInstrumentNumber);
     int drumInstrumentNumber = 5;
     writer.addNotes(comper::addSimpleDrumSwingPattern(totalDuration / 4), drumInstrumentNumber, true);
-    writer.write(argv[3]);
+    writer.write(arguments[2]);
     return 0;
 }
@@ -21,7 +21,8 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 
 #include "midiwriter.h"
 #include "note.h"
-#include "chord.h"
+#include "chordvalue.h"
+#include "notevalue.h"
 
 MidiWriter::MidiWriter() {
     _bpm = 120;
@@ -56,6 +57,15 @@ MidiWriter::MidiWriter(const int bpm, const double swing) {
 }
 
 void MidiWriter::addNotes(const std::vector<Note> &notes, const int instrument, bool drum) {
+    _addNotes(notes, instrument, drum);
+}
+
+void MidiWriter::addNotes(const std::vector<NoteValue> &notes, const int instrument, bool drum) {
+    _addNotes(notes, instrument, drum);
+}
+
+template <typename NoteType>
+void MidiWriter::_addNotes(const std::vector<NoteType> &notes, const int instrument, bool drum) {
     if(_track == 16) {
         throw std::runtime_error("You have too many tracks");
     }
@@ -83,7 +93,7 @@ void MidiWriter::addNotes(const std::vector<Note> &notes, const int instrument,
     ++_track;
 }
 
-void MidiWriter::addChords(const std::vector<Chord> &chords, const int instrument) {
+void MidiWriter::addChords(const std::vector<ChordValue> &chords, const int instrument) {
     if(_track == 16) {
         throw std::runtime_error("you have too many tracks");
     }
@@ -99,8 +109,8 @@ void MidiWriter::addChords(const std::vector<Chord> &chords, const int instrumen
         } else if(actionTick % _tpq != 0 && it->duration() == 8 && (it - 1)->duration() == 8) {
             swingTicks = -1 * (_swing * _tpq - 0.5 * _tpq);
         }
-        std::vector<Note> voicing = it->voicing();
-        for(Note nextNote : voicing) {
+        for(size_t i = 0; i < it->voicingSize(); ++i) {
+            NoteValue nextNote = it->voicingValue(i);
             if(nextNote.duration() == 0) {
                 throw std::runtime_error("Cannot add a note with duration 0");
             }
@@ -21,7 +21,8 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 #include <vector>
 
 #include "note.h"
-#include "chord.h"
+#include "chordvalue.h"
+#include "notevalue.h"
 #include "midifile/MidiFile.h"
 
 /// Writes Notes and Chords to midi files. Only supports quarter notes and eighth notes when we swing
@@ -39,13 +40,20 @@ public:
     /// Adds a line of notes to the beginning of our midi file
     void addNotes(const std::vector<Note> &notes, const int instrument, bool drum = false);
 
+    /// Adds a line of unnamed notes to the beginning of our midi file
+    void addNotes(const std::vector<NoteValue> &notes, const int instrument, bool drum = false);
+
     /// Adds a line of chords to the beginning of our midi file
-    void addChords(const std::vector<Chord> &chords, const int instrument);
+    void addChords(const std::vector<ChordValue> &chords, const int instrument);
 
     /// Writes our midi data to `fileName`
     void write(const std::string fileName);
 
 private:
+    // Adds a line of Notes or NoteValues, reading each one in place
+    template <typename NoteType>
+    void _addNotes(const std::vector<NoteType> &notes, const int instrument, bool drum);
+
     // The object that stores all our midi data
     smf::MidiFile midifile;
 
@@ -15,68 +15,59 @@ You should have received a copy of the GNU General Public License
 along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 */
 
-#include <regex>
 #include <string>
+#include <stdexcept> // std::runtime_error
 
 #include "note.h"
 #include "note_numbers.h"
 
 Note::Note() {
     _octave = MIDDLE_OCTAVE;
-    _duration = 0;
-    _velocity = 0;
+    _value = NoteValue(0, 0, 0);
     setName("C");
 }
 
 Note::Note(const std::string name) {
     _octave = MIDDLE_OCTAVE;
-    _duration = 0;
-    _velocity = 0;
+    _value = NoteValue(0, 0, 0);
     setName(name);
 }
 
 Note::Note(const std::string name, const int octave) {
     _octave = octave;
-    _duration = 0;
-    _velocity = 0;
+    _value = NoteValue(0, 0, 0);
     setName(name);
 }
 
 Note::Note(const std::string name, const int octave, const int duration) {
     _octave = octave;
-    _duration = duration;
-    _velocity = 0;
+    _value = NoteValue(0, duration, 0);
     setName(name);
 }
 
 Note::Note(const std::string name, const int octave, const int duration, const int velocity) {
     _octave = octave;
-    _duration = duration;
-    _velocity = velocity;
+    _value = NoteValue(0, duration, velocity);
     setName(name);
 }
 
 Note::Note(const int midiNumber) {
-    _duration = 0;
-    _velocity = 0;
-    _midiNumber = midiNumber;
-    _setName();
+    _value = NoteValue(midiNumber, 0, 0);
     _setOctave();
 }
 
 Note::Note(const int midiNumber, const int duration) {
-    _duration = duration;
-    _velocity = 0;
-    _midiNumber = midiNumber;
-    _setName();
+    _value = NoteValue(midiNumber, duration, 0);
     _setOctave();
 }
 
 Note::Note(const int midiNumber, const int duration, const int velocity) {
-    _duration = duration;
-    _velocity = velocity;
-    _midiNumber = midiNumber;
-    _setName();
+    _value = NoteValue(midiNumber, duration, velocity);
+    _setOctave();
+}
+
+Note::Note(const NoteValue value) {
+    _value = value;
     _setOctave();
 }
 
@@ -86,18 +77,16 @@ Note &Note::operator=(const std::string name) {
 }
 
 Note &Note::operator=(const int number) {
-    _midiNumber = number;
-    _setName();
-    _setOctave();
+    setNumber(number);
     return *this;
 }
 
 Note Note::operator+(const int amount) const {
-    return Note(_midiNumber + amount, this->_duration, this->_velocity);
+    return Note(_value + amount);
 }
 
 Note &Note::operator+=(const int amount) {
-    setNumber(_midiNumber + amount);
+    setNumber(_value.number() + amount);
     return *this;
 }
 
@@ -106,17 +95,15 @@ int Note::operator-(const Note &note) const {
 }
 
 bool Note::operator==(const Note &note) const {
-    return note._midiNumber == this->_midiNumber &&
-            note._duration == this->_duration &&
-            note._velocity == this->_velocity;
+    return note._value == this->_value;
 }
 
 bool Note::operator==(const int midiNumber) const {
-    return midiNumber == _midiNumber;
+    return midiNumber == _value.number();
 }
 
 bool Note::operator==(const std::string name) const {
-    return number(name) == _midiNumber;
+    return number(name) == _value.number();
 }
 
 bool Note::operator!=(const Note &note) const {
@@ -132,39 +119,32 @@ bool Note::operator!=(const std::string name) const {
 }
 
 bool Note::operator>(const Note &note) const {
-    return this->_midiNumber > note.number();
+    return this->_value > note._value;
 }
 
 bool Note::operator<(const Note &note) const {
-    return this->_midiNumber < note.number();
+    return this->_value < note._value;
 }
 
 bool Note::operator>=(const Note &note) const {
-    return this->_midiNumber >= note.number();
+    return this->_value >= note._value;
 }
 
 bool Note::operator<=(const Note &note) const {
-    return this->_midiNumber <= note.number();
+    return this->_value <= note._value;
 }
 
 std::string Note::name() const {
-    return _name;
-}
-
-int Note::number(std::string name) const {
-    int midiNumber = MIDI_NUMBERS.at(toupper(name[0]));
-    // Make sure that we don't count the note 'b' as 'bb'
-    name = name.substr(1);
-    // Adjust for sharps and flats
-    if(std::regex_search(name, std::regex("##"))) {
-        midiNumber += 2;
-    } else if(std::regex_search(name, std::regex("#"))) {
-        ++midiNumber;
-    } else if(std::regex_search(name, std::regex("bb"))) {
-        midiNumber -= 2;
-    } else if(std::regex_search(name, std::regex("b"))) {
-        --midiNumber;
+    return _name.empty() ? _spell(_value.number()) : _name;
+}
+
+int Note::number(const std::string &name) const {
+    int midiNumber = name.empty() ? -1 : letterNumber(name[0]);
+    if(midiNumber < 0) {
+        throw std::runtime_error(name + " is an invalid note name");
     }
+    // Skip the letter so that we don't count the note 'b' as a flat
+    midiNumber += accidentalOffset(name.data() + 1, name.size() - 1);
     if(midiNumber < 0) {
         midiNumber += NUM_NOTES;
     }
@@ -173,7 +153,11 @@ int Note::number(std::string name) const {
 }
 
 int Note::number() const {
-    return _midiNumber;
+    return _value.number();
+}
+
+NoteValue Note::value() const {
+    return _value;
 }
 
 int Note::octave() const {
@@ -181,11 +165,11 @@ int Note::octave() const {
 }
 
 int Note::duration() const {
-    return _duration;
+    return _value.duration();
 }
 
 int Note::velocity() const {
-    return _velocity;
+    return _value.velocity();
 }
 
 void Note::setName(const std::string name) {
@@ -196,70 +180,66 @@ void Note::setName(const std::string name) {
 
 void Note::setOctave(const int octave) {
     _octave = octave;
-    _setNumber();
+    if(_name.empty()) {
+        // Same as reading our spelled name in the new octave without spelling it
+        _value = _value.withOctave(octave);
+    } else {
+        _setNumber();
+    }
 }
 
 void Note::setNumber(const int number) {
-    _midiNumber = number;
-    _setName();
+    _value = _value.withNumber(number);
+    _name.clear();
     _setOctave();
 }
 
 void Note::setVelocity(const int velocity) {
-    _velocity = velocity;
+    _value = _value.withVelocity(velocity);
 }
 
 void Note::setDuration(const int duration) {
-    _duration = duration;
+    _value = _value.withDuration(duration);
 }
 
 int Note::distance(const Note &note) const {
-    return abs(note.number() - this->_midiNumber);
+    return _value - note._value;
 }
 
 int Note::shortestDistance(const Note &note) const {
-    int longDistance = distance(note);
-    if(longDistance > NUM_NOTES) {
-        return std::min(NUM_NOTES - longDistance % NUM_NOTES, longDistance % NUM_NOTES);
-    }
-    return longDistance;
+    return _value.shortestDistance(note._value);
 }
 
 Note Note::closest(const std::string name) const {
-    Note note(name, _octave, _duration, _velocity);
-    if(note.number() < this->_midiNumber - NUM_NOTES / 2) {
+    Note note(name, _octave, _value.duration(), _value.velocity());
+    if(note.number() < _value.number() - NUM_NOTES / 2) {
         note.setOctave(note.octave() + 1);
-    } else if(note.number() > this->_midiNumber + NUM_NOTES / 2) {
+    } else if(note.number() > _value.number() + NUM_NOTES / 2) {
         note.setOctave(note.octave() - 1);
     }
     return note;
 }
 
 void Note::_setNumber() {
-    _midiNumber = number(_name);
+    _value = _value.withNumber(number(_name));
 }
 
-void Note::_setName() {
-    /// @cite https://stackoverflow.com/questions/3136520/determine-if-map-contains-a-value-for-a-key
-     auto it = MIDI_NAMES.find(_midiNumber % 12);
-    if(it != MIDI_NAMES.end()) {
-        _name = MIDI_NAMES.at(_midiNumber % 12);
-    } else {
-        // C# and Db are expressed as Db.
-        _name = MIDI_NAMES.at(_midiNumber % 12 + 1);
-        _name += "b";
+std::string Note::_spell(const int midiNumber) {
+    if(midiNumber < 0) {
+        throw std::runtime_error(std::to_string(midiNumber) + " is not a valid midi number");
     }
+    // C# and Db are expressed as Db.
+    return MIDI_NAMES[midiNumber % NUM_NOTES];
 }
 
 void Note::_setOctave() {
-    _octave = MIDI_START_OCTAVE + _midiNumber / NUM_NOTES;
+    _octave = _value.octave();
 }
 
 void Note::_checkName() {
     /* A valid note name must start with a valid letter. It doesn't really matter if
        it has a letter and then garbage after(like C#KJHDF would just be interpreted as C#) */
-    std::regex validNameExp("^[A-Ga-g](.*)");
-    if(!std::regex_match(_name, validNameExp)) {
+    if(_name.empty() || letterNumber(_name[0]) < 0) {
         throw std::runtime_error(_name + " is an invalid note name");
     }
 }
@@ -20,6 +20,8 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 
 #include <string>
 
+#include "notevalue.h"
+
 /**
  * @class Note
  * @brief Stores and calculates a note's name, midi number, duration, velocity, and octave
@@ -30,6 +32,8 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
  * @example if duration = 4, duration is (4 notes)/(whole note) or a quarter note
  * velocity is the velocity as specified in the midi file
  * octave is the octave number. Middle C on the piano is octave 5. Note that B# oct. 6 == C oct. 7
+ * Everything but the name and octave lives in a NoteValue. A note only keeps a name if it was given one,
+ * otherwise the name is spelled from the midi number whenever it is asked for
  * @author Joseph Tan
  */
 
@@ -63,6 +67,9 @@ public:
     */
     Note(const int midiNumber, const int duration, const int velocity);
 
+    /// Use the midi number, duration and velocity of `value`
+    explicit Note(const NoteValue value);
+
     /// Changes our name to `name` and adjusts midiNumber accordingly
     Note &operator=(const std::string name);
 
@@ -112,11 +119,14 @@ public:
     std::string name() const;
 
     /// Given a name, return the midi number of a note with the same name in the same octave
-    int number(std::string name) const;
+    int number(const std::string &name) const;
 
     /// Return our midiNumber
     int number() const;
 
+    /// Return our midi number, duration and velocity without the name
+    NoteValue value() const;
+
     /// Return our octave
     int octave() const;
 
@@ -135,10 +145,10 @@ public:
     /// Set our midi number to `number` and adjust name and octave accordingly
     void setNumber(const int number);
 
-    /// Set our velocity to `velocity`
+    /// Set our velocity to `velocity`. Throws an error if it isn't between 0 and 255
     void setVelocity(const int velocity);
 
-    /// Set the note duration to `duration`
+    /// Set the note duration to `duration`. Throws an error if it isn't between 0 and 255
     void setDuration(const int duration);
 
     /// Return the distance between our note and `note` in semitones
@@ -152,14 +162,19 @@ public:
 
 
 protected:
+    NoteValue _value;
+    int _octave;
+
+    // The name we were given. Empty if our midi number was set directly
     std::string _name;
-    int _midiNumber, _octave, _velocity, _duration;
 
-    // Adjusts class number, name, and octave depending on _name, _midiNumber, and _octave
+    // Adjusts our midi number according to _name and _octave and our octave according to the midi number
     void _setNumber();
-    void _setName();
     void _setOctave();
 
+    // Spell the name of `midiNumber`, using flats for accidentals. Throws an error if it is negative
+    static std::string _spell(const int midiNumber);
+
     // Throws an error if the note name is incorrect
     void _checkName();
 };
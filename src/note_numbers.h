@@ -18,25 +18,57 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 #ifndef NOTE_NUMBERS_H
 #define NOTE_NUMBERS_H
 
-#include <map>
-
-// Map notes to midi numbers
-const std::map<char, int> MIDI_NUMBERS = {{'C', 0},
-                                    {'D', 2},
-                                    {'E', 4},
-                                    {'F', 5},
-                                    {'G', 7},
-                                    {'A', 9},
-                                    {'B', 11}};
-
-// Sometimes we want to map midi numbers to notes.
-const std::map<int, char> MIDI_NAMES = {{0, 'C'},
-                                  {2, 'D'},
-                                  {4, 'E'},
-                                  {5, 'F'},
-                                  {7, 'G'},
-                                  {9, 'A'},
-                                  {11, 'B'}};
+#include <cstdint>
+#include <cstddef> // size_t
+
+// Maps each character to the midi number of the note letter it names in octave 0, or -1 if it isn't one
+struct LetterNumbers {
+    int8_t numbers[256];
+};
+
+constexpr LetterNumbers makeLetterNumbers() {
+    LetterNumbers ret = {};
+    for(int c = 0; c < 256; ++c) {
+        ret.numbers[c] = -1;
+    }
+    const char letters[] = "CDEFGAB";
+    const int8_t numbers[] = {0, 2, 4, 5, 7, 9, 11};
+    for(int i = 0; i < 7; ++i) {
+        ret.numbers[(unsigned char)letters[i]] = numbers[i];
+        ret.numbers[(unsigned char)letters[i] - 'A' + 'a'] = numbers[i];
+    }
+    return ret;
+}
+
+constexpr LetterNumbers MIDI_NUMBERS = makeLetterNumbers();
+
+// Return the midi number of note letter `letter` in octave 0 or -1 if it isn't a note letter
+constexpr int letterNumber(const char letter) {
+    return MIDI_NUMBERS.numbers[(unsigned char)letter];
+}
+
+/**
+ * Return how many semitones the accidentals in the `size` characters at `accidentals` raise a note by.
+ * Like the rest of a note name, they are searched rather than parsed: anywhere a ## appears means +2,
+ * otherwise a # means +1, otherwise a bb means -2, otherwise a b means -1
+ */
+constexpr int accidentalOffset(const char *accidentals, const size_t size) {
+    bool doubleSharp = false, sharp = false, doubleFlat = false, flat = false;
+    for(size_t i = 0; i < size; ++i) {
+        bool doubled = i + 1 < size && accidentals[i + 1] == accidentals[i];
+        if(accidentals[i] == '#') {
+            sharp = true;
+            doubleSharp = doubleSharp || doubled;
+        } else if(accidentals[i] == 'b') {
+            flat = true;
+            doubleFlat = doubleFlat || doubled;
+        }
+    }
+    return doubleSharp ? 2 : sharp ? 1 : doubleFlat ? -2 : flat ? -1 : 0;
+}
+
+// The name of each of the 12 notes of an octave starting from C, using flats for accidentals
+constexpr const char *MIDI_NAMES[] = {"C", "Db", "D", "Eb", "E", "F", "Gb", "G", "Ab", "A", "Bb", "B"};
 
 // there are 12 total notes
 const int NUM_NOTES = 12;
@@ -49,4 +81,55 @@ const int MIDI_START_OCTAVE = 0;
 // The octave and midi number of middle C
 const int MIDDLE_C = 60;
 const int MIDDLE_OCTAVE = MIDDLE_C / NUM_NOTES - NUM_NOTES * MIDI_START_OCTAVE;
+
+/*
+ * For each pitch class, how many semitones above and below it the nearest other pitch class in a set
+ * is. 0 if the set has no other pitch class
+ */
+struct PitchNeighbours {
+    int8_t up[NUM_NOTES];
+    int8_t down[NUM_NOTES];
+};
+
+// Return the neighbours within the set of pitch classes whose bits are set in `mask`
+constexpr PitchNeighbours makePitchNeighbours(const int mask) {
+    PitchNeighbours ret = {};
+    for(int pitchClass = 0; pitchClass < NUM_NOTES; ++pitchClass) {
+        for(int distance = NUM_NOTES - 1; distance > 0; --distance) {
+            if(mask >> (pitchClass + distance) % NUM_NOTES & 1) {
+                ret.up[pitchClass] = (int8_t)distance;
+            }
+            if(mask >> (pitchClass + NUM_NOTES - distance) % NUM_NOTES & 1) {
+                ret.down[pitchClass] = (int8_t)distance;
+            }
+        }
+    }
+    return ret;
+}
+
+/*
+ * steps[from][to] is how many semitones a note with pitch class `from` moves to reach the nearest note with
+ * pitch class `to`, like NoteValue::closest. Between -6 and 6
+ */
+struct ClosestSteps {
+    int8_t steps[NUM_NOTES][NUM_NOTES];
+};
+
+constexpr ClosestSteps makeClosestSteps() {
+    ClosestSteps ret = {};
+    for(int from = 0; from < NUM_NOTES; ++from) {
+        for(int to = 0; to < NUM_NOTES; ++to) {
+            int step = to - from;
+            if(step < -NUM_NOTES / 2) {
+                step += NUM_NOTES;
+            } else if(step > NUM_NOTES / 2) {
+                step -= NUM_NOTES;
+            }
+            ret.steps[from][to] = (int8_t)step;
+        }
+    }
+    return ret;
+}
+
+constexpr ClosestSteps CLOSEST_STEPS = makeClosestSteps();
 #endif // NOTE_NUMBERS_H
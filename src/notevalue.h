@@ -0,0 +1,169 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef NOTEVALUE_H
+#define NOTEVALUE_H
+#include <cstdint>
+#include <cstdlib> // abs
+#include <string>
+#include <stdexcept> // std::runtime_error
+#include <algorithm> // std::min
+#include <type_traits> // std::is_trivially_copyable
+
+#include "note_numbers.h"
+
+/**
+ * Return `value` if it is between `lowest` and `highest`. Otherwise throw an error saying `what` is out of
+ * range, since narrowing it to fit would silently wrap it around
+ */
+constexpr int inRange(const char *what, const int value, const int lowest, const int highest) {
+    if(value < lowest || value > highest) {
+        throw std::runtime_error(std::string(what) + " " + std::to_string(value) + " is out of range: it must be "
+                                 "between " + std::to_string(lowest) + " and " + std::to_string(highest));
+    }
+    return value;
+}
+
+/**
+ * A note as 4 bytes: its midi number, duration and velocity, meaning the same as in Note. It has no
+ * name, so it is trivially copyable and nothing about it ever allocates. Generation works on these and
+ * Note is a named facade over one. The octave is always the one the midi number is in
+ */
+class NoteValue {
+public:
+    NoteValue() = default;
+
+    /// Throws an error if `number` doesn't fit in 16 bits or `duration` or `velocity` don't fit in a byte
+    constexpr NoteValue(const int number, const int duration = 0, const int velocity = 0)
+        : _number((int16_t)inRange("Midi number", number, INT16_MIN, INT16_MAX)),
+          _duration((uint8_t)inRange("Duration", duration, 0, UINT8_MAX)),
+          _velocity((uint8_t)inRange("Velocity", velocity, 0, UINT8_MAX)) {}
+
+    /// Return our midi number
+    constexpr int number() const {
+        return _number;
+    }
+
+    /// Return our duration
+    constexpr int duration() const {
+        return _duration;
+    }
+
+    /// Return our velocity
+    constexpr int velocity() const {
+        return _velocity;
+    }
+
+    /// Return the octave our midi number is in
+    constexpr int octave() const {
+        return MIDI_START_OCTAVE + _number / NUM_NOTES;
+    }
+
+    /// Return which of the 12 notes of an octave we are. 0 is C
+    constexpr int pitchClass() const {
+        return _number % NUM_NOTES;
+    }
+
+    /// Return a copy of us with midi number `number`
+    constexpr NoteValue withNumber(const int number) const {
+        return NoteValue(number, _duration, _velocity);
+    }
+
+    /// Return the note with our pitch class in octave `octave`
+    constexpr NoteValue withOctave(const int octave) const {
+        return withNumber(pitchClass() + NUM_NOTES * (octave - MIDI_START_OCTAVE));
+    }
+
+    /// Return a copy of us with duration `duration`
+    constexpr NoteValue withDuration(const int duration) const {
+        return NoteValue(_number, duration, _velocity);
+    }
+
+    /// Return a copy of us with velocity `velocity`
+    constexpr NoteValue withVelocity(const int velocity) const {
+        return NoteValue(_number, _duration, velocity);
+    }
+
+    /// Returns a note that is our note incremented by `amount` semitones
+    constexpr NoteValue operator+(const int amount) const {
+        return withNumber(_number + amount);
+    }
+
+    /// Returns the absolute distance between this note and `note` in semitones
+    int operator-(const NoteValue note) const {
+        return abs(note._number - _number);
+    }
+
+    /// Return the distance between our note and the closest note with the same pitch class as `note`
+    int shortestDistance(const NoteValue note) const {
+        int longDistance = *this - note;
+        if(longDistance > NUM_NOTES) {
+            return std::min(NUM_NOTES - longDistance % NUM_NOTES, longDistance % NUM_NOTES);
+        }
+        return longDistance;
+    }
+
+    /**
+     * Return the note with pitch class `pitchClass` nearest to us. Starts from our octave and moves an
+     * octave up or down if that is more than half an octave away, like Note::closest
+     */
+    NoteValue closest(const int pitchClass) const {
+        NoteValue note = withNumber(pitchClass + NUM_NOTES * (octave() - MIDI_START_OCTAVE));
+        if(note._number < _number - NUM_NOTES / 2) {
+            return note + NUM_NOTES;
+        } else if(note._number > _number + NUM_NOTES / 2) {
+            return note + -NUM_NOTES;
+        }
+        return note;
+    }
+
+    /// Compares every field of this note with `note`
+    constexpr bool operator==(const NoteValue note) const {
+        return _number == note._number && _duration == note._duration && _velocity == note._velocity;
+    }
+
+    constexpr bool operator!=(const NoteValue note) const {
+        return !(*this == note);
+    }
+
+    /// Compares the midi numbers of this note and `note`
+    constexpr bool operator<(const NoteValue note) const {
+        return _number < note._number;
+    }
+
+    constexpr bool operator>(const NoteValue note) const {
+        return _number > note._number;
+    }
+
+    constexpr bool operator<=(const NoteValue note) const {
+        return _number <= note._number;
+    }
+
+    constexpr bool operator>=(const NoteValue note) const {
+        return _number >= note._number;
+    }
+
+private:
+    int16_t _number;
+    uint8_t _duration;
+    uint8_t _velocity;
+};
+
+static_assert(sizeof(NoteValue) == 4 && std::is_trivially_copyable<NoteValue>::value,
+              "NoteValue should be 4 trivially copyable bytes");
+
+#endif // NOTEVALUE_H
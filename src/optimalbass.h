@@ -0,0 +1,178 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPTIMALBASS_H
+#define OPTIMALBASS_H
+#include <vector>
+#include <cstdint>
+#include <climits> // INT_MAX
+#include <algorithm> // std::max, std::min
+#include <stdexcept> // std::runtime_error
+
+#include "note.h"
+#include "notevalue.h"
+#include "probcfg.h"
+#include "cfgstream.h"
+#include "note_numbers.h"
+#include "random.h"
+#include "walkingbass.h"
+
+namespace comper {
+    /**
+     * Generates a walking bassline from patterns and directions drawn like genWalkingBassline's, but picks
+     * the whole line at once instead of one note at a time. See genSimpleWalkingBassline for what the
+     * parameters and the characters of each pattern mean.
+     *
+     * The greedy lines follow each pattern character in its drawn direction until they pass `lowestNote` or
+     * `highestNote` and then get turned around. Here every note may instead go the other way for a price,
+     * and the line that costs the least over the whole progression is found with the Viterbi algorithm.
+     * A note costs:
+     *  - nothing if it goes the way it was drawn and 2 if it goes the other way
+     *  - 3 for each semitone it is outside of `lowestNote` and `highestNote`
+     *  - 4 for each octave it has to be moved to stay within an octave of them
+     *  - for the last note of a chord, 2 unless it leads to the next bass note from a semitone, a whole
+     *    step or a fourth/fifth away
+     * The states are the midi numbers from an octave below `lowestNote` to an octave above `highestNote`,
+     * and each note only has two ways to go, so this takes O(beats x range) time and memory.
+     * Ties are broken towards the drawn directions and then towards lower notes. The first note is the
+     * first bass note between the limit notes, as in genWalkingBassline. The tables are kept per thread
+     * like genWalkingBassline's, so once they have grown big enough only the bassline is allocated
+     */
+    std::vector<NoteValue> genOptimalWalkingBassline(const std::vector<quarterNoteChord> &progression,
+            const ProbCFG &patternCFG, const ProbCFG &directionCFG, const Note lowestNote,
+            const Note highestNote, Random &random, int velocity = 100) {
+        if(lowestNote > highestNote) {
+            throw std::runtime_error("LowestNote should be below highestNote");
+        }
+        const int directionCost = 2, rangeCost = 3, foldCost = 4, leadingCost = 2;
+        const int unreachable = INT_MAX / 2;
+        const int lowest = lowestNote.number(), highest = highestNote.number();
+        const int low = lowest - NUM_NOTES, high = highest + NUM_NOTES, range = high - low + 1;
+        int totalDuration = 0;
+        for(const quarterNoteChord &chord : progression) {
+            totalDuration += chord.duration();
+        }
+        /* cost[i] is what the cheapest line ending on midi number low + i costs and from[beat * range + i]
+         * is the state that line was in the beat before */
+        thread_local std::vector<int> cost, next;
+        thread_local std::vector<int16_t> from;
+        cost.assign(range, unreachable);
+        next.resize(range);
+        from.clear();
+        from.reserve((size_t)std::max(totalDuration, 0) * range);
+        const int startOctave = (lowestNote.octave() + highestNote.octave()) / 2;
+        int start = 0;
+        thread_local CFGStream pattern, directions;
+        thread_local BassSteps steps;
+        // Move every line on to the next beat. `step` says how far one note moves in one direction
+        auto advance = [&](const bool drawnUp, auto step) {
+            std::fill(next.begin(), next.end(), unreachable);
+            size_t beat = from.size();
+            from.resize(beat + range, -1);
+            for(int i = 0; i < range; ++i) {
+                if(cost[i] == unreachable) {
+                    continue;
+                }
+                for(bool up : {drawnUp, !drawnUp}) {
+                    int number = low + i + step(up, BassSteps::pitchClass(low + i));
+                    int total = cost[i] + (up != drawnUp) * directionCost;
+                    for(; number > high; number -= NUM_NOTES) {
+                        total += foldCost;
+                    }
+                    for(; number < low; number += NUM_NOTES) {
+                        total += foldCost;
+                    }
+                    total += rangeCost * std::max({0, number - highest, lowest - number});
+                    total += step.extra(number);
+                    if(total < next[number - low]) {
+                        next[number - low] = total;
+                        from[beat + number - low] = (int16_t)i;
+                    }
+                }
+            }
+            cost.swap(next);
+        };
+        for(size_t chord = 0; chord < progression.size(); ++chord) {
+            steps.select(progression[chord]);
+            const int duration = progression[chord].duration();
+            patternCFG.stream(duration, random, pattern);
+            directionCFG.stream(duration, random, directions);
+            for(int i = 0; i < duration - 1; ++i) {
+                int action = BASS_ACTIONS.actions[(unsigned char)pattern.next()];
+                char direction = directions.next();
+                if(action == EndOfPattern || direction == '\0') {
+                    throw std::runtime_error("One of the provided CFGs produced output that was too short");
+                }
+                // Begin with the first root in the progression between the limit notes
+                if(from.empty()) {
+                    start = progression[chord].value().bass().withOctave(startOctave).number();
+                    cost[start - low] = 0;
+                    from.resize(range, -1);
+                    continue;
+                } else if(action < 0) {
+                    throw std::runtime_error(action == IllegalDigit ? "can only have the digits 0-7" :
+                            "Illegal character in CFG");
+                }
+                struct {
+                    const BassSteps &steps;
+                    int action;
+                    int operator()(const bool up, const int pitchClass) const {
+                        return steps.step(action, up, pitchClass);
+                    }
+                    int extra(int) const {
+                        return 0;
+                    }
+                } patternMove = {steps, action};
+                advance(direction == 'U', patternMove);
+            }
+            // Lead to the next chord's bass, preferring the strongest leading notes
+            char direction = directions.next();
+            if(direction == '\0') {
+                throw std::runtime_error("One of the provided CFGs produced output that was too short");
+            } else if(from.empty()) {
+                throw std::runtime_error("The first chord must last at least 2 beats");
+            }
+            struct {
+                BassSteps &steps;
+                int nextBass;
+                int operator()(const bool up, const int pitchClass) const {
+                    return steps.leadingStep(up, pitchClass, nextBass);
+                }
+                int extra(const int number) const {
+                    int distance = NoteValue(number).shortestDistance(NoteValue(nextBass));
+                    return distance == 1 || distance == 2 || distance == 5 ? 0 : leadingCost;
+                }
+                int leadingCost;
+            } leadingMove = {steps, progression[(chord + 1) % progression.size()].value().bass().pitchClass(),
+                             leadingCost};
+            advance(direction == 'U', leadingMove);
+        }
+        if(from.empty()) {
+            return std::vector<NoteValue>();
+        }
+        // Follow the cheapest line back from its last note. The line ends with its first note again
+        std::vector<NoteValue> bassline(from.size() / range + 1);
+        int state = (int)(std::min_element(cost.begin(), cost.end()) - cost.begin());
+        for(size_t beat = bassline.size() - 1; beat-- > 0; ) {
+            bassline[beat] = NoteValue(low + state, 4, velocity);
+            state = from[beat * range + state];
+        }
+        bassline.back() = bassline[0].withDuration(1);
+        return bassline;
+    }
+} // comper
+#endif
@@ -0,0 +1,174 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm> // std::sort
+#include <cmath> // std::sqrt
+#include <stdexcept> // std::runtime_error
+
+#include "prefixdistribution.h"
+#include "probcfg.h"
+#include "compiledcfg.h"
+#include "stringbatch.h"
+#include "random.h"
+
+PrefixDistribution::PrefixDistribution(const ProbCFG &cfg, const int steps, const int prefixLength,
+                                       Random &random, const int samples, const int threads,
+                                       const size_t maxOutcomes)
+    : _prefixLength(prefixLength), _maxOutcomes(maxOutcomes) {
+    if(!cfg.compiled()) {
+        throw std::runtime_error("Only compiled CFGs can be analyzed");
+    } else if(steps < 0 || prefixLength < 0) {
+        throw std::runtime_error("Steps and prefix length cannot be negative");
+    }
+    const CompiledCFG &grammar = *cfg.compiled();
+    // expected[n][t] is the expected length of what nonterminal t generates with n steps left
+    std::vector<std::vector<double>> expected(steps + 1, std::vector<double>(grammar.nonterminalCount()));
+    for(int n = 1; n <= steps; ++n) {
+        for(int nonterminal = 0; nonterminal < grammar.nonterminalCount(); ++nonterminal) {
+            for(int alternative = grammar.alternativesBegin(nonterminal);
+                    alternative < grammar.alternativesEnd(nonterminal); ++alternative) {
+                double length = 0;
+                for(const int *symbol = grammar.expansionBegin(alternative);
+                        symbol < grammar.expansionEnd(alternative); ++symbol) {
+                    length += CompiledCFG::isTerminal(*symbol) ?
+                                grammar.terminalSize(CompiledCFG::terminalIndex(*symbol)) :
+                                expected[n - 1][*symbol];
+                }
+                expected[n][nonterminal] += length * grammar.weight(alternative) /
+                        grammar.totalWeight(nonterminal);
+            }
+        }
+    }
+    _expectedLength = expected[steps][grammar.start()];
+    std::map<std::string, double> distribution;
+    _isExact = _exact(grammar, steps, distribution);
+    if(_isExact) {
+        for(const auto &outcome : distribution) {
+            _outcomes.push_back({outcome.first, outcome.second, 0});
+        }
+    } else {
+        // Too many outcomes to list exactly so count how often each prefix shows up instead
+        _samples = samples;
+        StringBatch batch = cfg.generateBatch(steps, samples, random, threads);
+        std::map<std::string, int> counts;
+        for(size_t i = 0; i < batch.size(); ++i) {
+            ++counts[std::string(batch.data(i), std::min(batch.length(i), (size_t)prefixLength))];
+        }
+        for(const auto &count : counts) {
+            double probability = (double)count.second / samples;
+            _outcomes.push_back({count.first, probability,
+                                 1.96 * std::sqrt(probability * (1 - probability) / samples)});
+        }
+    }
+    std::sort(_outcomes.begin(), _outcomes.end(), [](const Outcome &a, const Outcome &b) {
+        return a.probability > b.probability || (a.probability == b.probability && a.prefix < b.prefix);
+    });
+}
+
+bool PrefixDistribution::_exact(const CompiledCFG &grammar, const int steps,
+                                std::map<std::string, double> &distribution) const {
+    const int nonterminals = grammar.nonterminalCount();
+    // needed[n][t] is true if <START> can reach nonterminal t with n steps left
+    std::vector<std::vector<bool>> needed(steps + 1, std::vector<bool>(nonterminals));
+    needed[steps][grammar.start()] = true;
+    for(int n = steps; n > 0; --n) {
+        for(int nonterminal = 0; nonterminal < nonterminals; ++nonterminal) {
+            if(!needed[n][nonterminal]) {
+                continue;
+            }
+            // Every alternative's symbols are back to back
+            for(const int *symbol = grammar.expansionBegin(grammar.alternativesBegin(nonterminal));
+                    symbol < grammar.expansionEnd(grammar.alternativesEnd(nonterminal) - 1); ++symbol) {
+                if(!CompiledCFG::isTerminal(*symbol)) {
+                    needed[n - 1][*symbol] = true;
+                }
+            }
+        }
+    }
+    // The distribution of every needed nonterminal with n - 1 steps left(previous) and n steps left(current)
+    std::vector<std::map<std::string, double>> previous(nonterminals), current(nonterminals);
+    for(int n = 0; n <= steps; ++n) {
+        for(int nonterminal = 0; nonterminal < nonterminals; ++nonterminal) {
+            std::map<std::string, double> &ret = current[nonterminal];
+            ret.clear();
+            if(!needed[n][nonterminal]) {
+                continue;
+            } else if(n == 0) {
+                ret[""] = 1; // Nonterminals with no steps left are deleted
+                continue;
+            }
+            for(int alternative = grammar.alternativesBegin(nonterminal);
+                    alternative < grammar.alternativesEnd(nonterminal); ++alternative) {
+                // Add one symbol at a time onto every prefix of the symbols before it
+                std::map<std::string, double> prefixes = {{"", 1}};
+                for(const int *symbol = grammar.expansionBegin(alternative);
+                        symbol < grammar.expansionEnd(alternative); ++symbol) {
+                    std::map<std::string, double> next;
+                    for(const auto &prefix : prefixes) {
+                        if(prefix.first.size() == (size_t)_prefixLength) {
+                            // Nothing after a full prefix can change it
+                            next[prefix.first] += prefix.second;
+                        } else if(CompiledCFG::isTerminal(*symbol)) {
+                            int terminal = CompiledCFG::terminalIndex(*symbol);
+                            std::string extended = prefix.first + std::string(grammar.terminalData(terminal),
+                                                                              grammar.terminalSize(terminal));
+                            next[extended.substr(0, _prefixLength)] += prefix.second;
+                        } else {
+                            for(const auto &suffix : previous[*symbol]) {
+                                next[(prefix.first + suffix.first).substr(0, _prefixLength)] +=
+                                        prefix.second * suffix.second;
+                            }
+                        }
+                    }
+                    if(next.size() > _maxOutcomes) {
+                        return false;
+                    }
+                    prefixes.swap(next);
+                }
+                double probability = (double)grammar.weight(alternative) / grammar.totalWeight(nonterminal);
+                for(const auto &prefix : prefixes) {
+                    ret[prefix.first] += probability * prefix.second;
+                }
+                if(ret.size() > _maxOutcomes) {
+                    return false;
+                }
+            }
+        }
+        previous.swap(current);
+    }
+    distribution.swap(previous[grammar.start()]);
+    return true;
+}
+
+bool PrefixDistribution::exact() const {
+    return _isExact;
+}
+
+int PrefixDistribution::samples() const {
+    return _samples;
+}
+
+double PrefixDistribution::expectedLength() const {
+    return _expectedLength;
+}
+
+const std::vector<PrefixDistribution::Outcome> &PrefixDistribution::outcomes() const {
+    return _outcomes;
+}
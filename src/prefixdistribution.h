@@ -0,0 +1,85 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PREFIXDISTRIBUTION_H
+#define PREFIXDISTRIBUTION_H
+#include <vector>
+#include <string>
+#include <map>
+#include <cstddef> // size_t
+
+#include "probcfg.h"
+#include "compiledcfg.h"
+#include "random.h"
+
+/**
+ * The probability of every prefix of up to prefixLength characters of the strings a ProbCFG generates
+ * in a given number of steps, along with their expected length. Strings shorter than prefixLength are
+ * their own prefix.
+ *
+ * The distribution is found exactly by dynamic programming over the compiled rules: the distribution of
+ * the prefixes a nonterminal generates with n steps left is the weighted sum over its alternatives of
+ * the concatenation of the distributions of its symbols with n - 1 steps left, cut off at prefixLength
+ * characters. If some nonterminal could generate more than maxOutcomes different prefixes we give up and
+ * estimate the distribution from generated strings instead, giving each probability a 95% confidence
+ * interval. The expected length is always exact.
+ */
+class PrefixDistribution {
+public:
+    /// A prefix and its probability
+    struct Outcome {
+        std::string prefix;
+        double probability;
+        // Half the width of the 95% confidence interval around probability. 0 if it is exact
+        double margin;
+    };
+
+    /**
+     * Find the distribution of the first `prefixLength` characters `cfg`, which must be compiled,
+     * generates in `steps` steps. If the exact distribution has too many outcomes estimate it from
+     * `samples` strings generated on `threads` threads drawing from `random`
+     */
+    PrefixDistribution(const ProbCFG &cfg, const int steps, const int prefixLength, Random &random,
+                       const int samples = 200000, const int threads = 1, const size_t maxOutcomes = 100000);
+
+    /// Return true if the distribution is exact and false if it was estimated
+    bool exact() const;
+
+    /// Return the number of strings the distribution was estimated from. 0 if it is exact
+    int samples() const;
+
+    /// Return the expected length of the whole generated string
+    double expectedLength() const;
+
+    /// Return every prefix that can be generated, most likely first
+    const std::vector<Outcome> &outcomes() const;
+
+private:
+    /* Put the exact distribution of the prefixes <START> generates with `steps` steps left in `distribution`.
+     * Works up from 0 steps left one step at a time, only keeping the distributions of the nonterminals
+     * <START> can reach with the previous number of steps left. Returns false if one has too many outcomes */
+    bool _exact(const CompiledCFG &grammar, const int steps, std::map<std::string, double> &distribution) const;
+
+    int _prefixLength;
+    size_t _maxOutcomes;
+    bool _isExact;
+    int _samples = 0;
+    double _expectedLength;
+    std::vector<Outcome> _outcomes;
+};
+
+#endif // PREFIXDISTRIBUTION_H
@@ -15,135 +15,371 @@ You should have received a copy of the GNU General Public License
 along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 */
 
-#include <regex>
 #include <set>
 #include <string>
 #include <vector>
-#include <queue>
 #include <iostream>
 #include <fstream>
+#include <memory> // std::shared_ptr
+#include <thread>
+#include <exception> // std::exception_ptr
+#include <algorithm> // std::min, std::max
+#include <cmath> // std::abs, std::sqrt
+#include <utility> // std::pair, std::move
 #include <stdexcept> // std::runtime_error
 
 #include "probcfg.h"
 #include "weighted_vector.h"
+#include "compiledcfg.h"
+#include "cfgstream.h"
+#include "stringbatch.h"
+#include "lengthbounds.h"
+#include "random.h"
 
+// The most characters generateString and generateBatch reserve for their output up front
+static const long long MAX_RESERVED = 1LL << 26;
 
-/* splits `toSplit` into a std::vector of std::strings separated by `delimeter` has multiple characters,
- * splits whenever we match one of delimeter's characters. Shifts our match over by shift*/
-std::vector<std::string> split(const std::string delimeter, const std::string toSplit) {
-    size_t previous = 0;
-    std::vector<std::string> ret;
-    for(size_t i = toSplit.find_first_of(delimeter); i != toSplit.npos;
-        i = toSplit.find_first_of(delimeter, i + 1)) {
-        ret.push_back(toSplit.substr(previous, i - previous));
-        previous = i;
-    }
-    ret.push_back(toSplit.substr(previous));
-    return ret;
+// Returns true if `c` can appear in a nonterminal name or a terminal
+bool isNameCharacter(const char c) {
+    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+            c == '-' || c == '+' || c == '_';
 }
 
-// Splits expansion into a std::vector of nonterminals and terminals
-std::vector<std::string> splitExpansion(const std::string expansion) {
-    if(expansion.empty()) {
-        return {expansion};
-    }
-    std::vector<std::string> ret;
-    std::string soFar;
-    for(char c : expansion) {
-        switch(c) {
-        case '<':
-            if(!soFar.empty()) {
-                ret.push_back(soFar);
-            }
-            soFar = "<";
-            break;
-        case '>':
-            ret.push_back(soFar + ">");
-            soFar.clear();
-            break;
-        default:
-            soFar += c;
-        }
-    }
-    if(!soFar.empty()) {
-        ret.push_back(soFar);
-    }
-    return ret;
+void ProbCFG::addRule(const std::string rule) {
+    addRule(rule, 0);
 }
 
-void ProbCFG::addRule(std::string rule) {
+// Validates `rule` and splits it into expansions and weights in a single pass over its characters
+void ProbCFG::addRule(std::string rule, const int line) {
     rule = rule.substr(0, rule.find_first_of('%')); // Remove everything after the comment sign('%')
-    if(regex_match(rule, std::regex("^( )*$"))) { // Exit if we have empty rule
+    size_t i = 0;
+    // Reports the first character that breaks the format described in probcfg.h
+    auto fail = [&rule, &i, line]() {
+        throw std::runtime_error("Rule '" + rule + "' is in incorrect format at " +
+                                 (line > 0 ? "line " + std::to_string(line) + ", " : "") +
+                                 "column " + std::to_string(i + 1));
+    };
+    auto skipSpaces = [&rule, &i]() {
+        while(i < rule.size() && rule[i] == ' ') {
+            ++i;
+        }
+    };
+    // Reads a <name> starting at i and returns it
+    auto readNonterminal = [&rule, &i, &fail]() {
+        size_t begin = i++;
+        while(i < rule.size() && isNameCharacter(rule[i])) {
+            ++i;
+        }
+        if(i == begin + 1 || i == rule.size() || rule[i] != '>') {
+            fail();
+        }
+        return rule.substr(begin, ++i - begin);
+    };
+    skipSpaces();
+    if(i == rule.size()) { // Exit if we have empty rule
         return;
-    } else if(!_isValidRule(rule)) {
-        throw std::runtime_error("Rule '" + rule + "' is in incorrect format");
+    } else if(rule[i] != '<') {
+        fail();
     }
-    // Find the first nonterminal and remove it
-    std::string initialNonterminal = rule.substr(rule.find_first_of("<"),
-                                            rule.find_first_of(">") - rule.find_first_of("<") + 1);
-    initialNonterminal = regex_replace(initialNonterminal, std::regex("^( )*"), "");
-    _missing.erase(initialNonterminal);
-    // Split at each expansion after the initial nonterminal
-    std::vector<std::string> splitRule = split("|", rule.substr(rule.find_first_of("=") + 1));
+    std::string initialNonterminal = readNonterminal();
+    skipSpaces();
+    if(i == rule.size() || rule[i] != '=') {
+        fail();
+    }
+    ++i;
+    skipSpaces();
     std::vector<std::vector<std::string>> expansions;
     std::vector<int> weights;
-    for(auto it = splitRule.begin(); it < splitRule.end(); ++it) {
-        /* Find location of first and last characters of each expansion and its weight and insert to
-         * our expansions and weights std::vector accordingly */
-        size_t expansionBegin = it->find_first_not_of("| ");
-        size_t expansionEnd = it->find_first_of(" ", expansionBegin);
-        size_t firstDigit = it->find_first_of("1234567890", expansionEnd + 1);
-        size_t lastDigit = it->find_first_not_of("1234567890", firstDigit) - 1;
-        weights.push_back(stoi(it->substr(firstDigit, lastDigit - firstDigit + 1)));
-        *it = it->substr(expansionBegin, expansionEnd - expansionBegin);
-        *it = *it == "`" ? "" : *it; // '`' stands for the empty std::string
-        expansions.push_back(splitExpansion(*it));
-        /* Add any nonterminals from the std::vector we just added to expansions that don't have any
-         * matching rule to our _missing set */
-        for(std::string exp : *(expansions.rbegin())) {
-            if(exp[0] == '<' && _rules.find(exp) == _rules.end() && exp != initialNonterminal) {
-                _missing.insert(exp);
+    while(true) {
+        // Read the expansion, splitting it into nonterminals and runs of terminal characters
+        std::vector<std::string> expansion;
+        if(i < rule.size() && rule[i] == '`') { // '`' stands for the empty string
+            expansion.push_back("");
+            ++i;
+        } else {
+            while(i < rule.size() && (rule[i] == '<' || isNameCharacter(rule[i]))) {
+                if(rule[i] == '<') {
+                    expansion.push_back(readNonterminal());
+                } else {
+                    size_t begin = i;
+                    while(i < rule.size() && isNameCharacter(rule[i])) {
+                        ++i;
+                    }
+                    expansion.push_back(rule.substr(begin, i - begin));
+                }
+            }
+            if(expansion.empty()) {
+                fail();
+            }
+        }
+        // The weight needs at least 1 space before it and must be greater than 0
+        if(i == rule.size() || rule[i] != ' ') {
+            fail();
+        }
+        skipSpaces();
+        size_t weightBegin = i;
+        long long weight = 0;
+        while(i < rule.size() && rule[i] >= '0' && rule[i] <= '9' && weight <= __INT_MAX__) {
+            weight = weight * 10 + (rule[i++] - '0');
+        }
+        if(weight <= 0 || weight > __INT_MAX__) {
+            i = weightBegin;
+            fail();
+        }
+        expansions.push_back(expansion);
+        weights.push_back((int)weight);
+        // Every subsequent expansion must be separated by a '|'
+        skipSpaces();
+        if(i == rule.size()) {
+            break;
+        } else if(rule[i] != '|') {
+            fail();
+        }
+        ++i;
+        skipSpaces();
+    }
+    _missing.erase(initialNonterminal);
+    /* Add any nonterminals from our expansions that don't have any matching rule to our _missing
+     * set */
+    for(const std::vector<std::string> &expansion : expansions) {
+        for(const std::string &element : expansion) {
+            if(!element.empty() && element[0] == '<' && _rules.find(element) == _rules.end() &&
+                    element != initialNonterminal) {
+                _missing.insert(element);
             }
         }
     }
     _rules[initialNonterminal].insert(expansions, weights);
+    _compiled = nullptr;
+    _bounds = nullptr;
+    _banks = nullptr;
 }
 
-std::string ProbCFG::generateString(int steps) {
-    if(_rules.find("<START>") == _rules.end()) {
+std::shared_ptr<const CompiledCFG> ProbCFG::_grammar() const {
+    if(_compiled) {
+        return _compiled;
+    } else if(_rules.find("<START>") == _rules.end()) {
         throw std::runtime_error("You need a rule with <START> on the left");
     } else if(!_missing.empty()) {
         throw std::runtime_error("There is a nonterminal on the right doesn't appear on the left");
     }
-    std::queue<std::string> soFar;
-    soFar.push("<START>");
-    while(steps-- > 0) {
-        for(int i = soFar.size(); i > 0; --i) {
-            std::string element = soFar.front();
-            soFar.pop();
-            soFar.front();
-            // Expand each nonTerminal in soFar and add to expanded
-            if(element.find('<') != element.npos) {
-                std::vector<std::string> expansion = _rules[element].getElement();
-                for(std::string s : expansion) {
-                    soFar.push(s);
-                }
-            }
-            // Add each terminal to expanded
-            else {
-                soFar.push(element);
+    return std::make_shared<const CompiledCFG>(_rules);
+}
+
+long long ProbCFG::_longest(const int steps) const {
+    if(!_bounds || steps > _bounds->maxSteps()) {
+        return LengthBounds::unbounded;
+    }
+    return _bounds->maximum(std::max(steps, 0));
+}
+
+std::string ProbCFG::generateString(int steps, Random &random) const {
+    if(hasBank(steps)) {
+        const StringBatch &bank = _banks->at(steps);
+        return bank[random.bounded((int)bank.size())];
+    }
+    std::shared_ptr<const CompiledCFG> grammar = _grammar();
+    std::vector<int> stack;
+    std::string ret;
+    // Reserve enough for the longest possible output if we know it and it isn't unreasonably large
+    long long longest = _longest(steps);
+    if(longest <= MAX_RESERVED) {
+        ret.reserve(longest);
+    }
+    grammar->generate(steps, random, stack, ret);
+    return ret;
+}
+
+// Append `count` strings generated from `grammar` to `characters` and where each one ends to `offsets`
+void generateInto(const CompiledCFG &grammar, const int steps, const int count, Random &random,
+                  std::string &characters, std::vector<size_t> &offsets) {
+    std::vector<int> stack;
+    for(int i = 0; i < count; ++i) {
+        grammar.generate(steps, random, stack, characters);
+        offsets.push_back(characters.size());
+    }
+}
+
+StringBatch ProbCFG::generateBatch(int steps, int count, Random &random, int threads) const {
+    if(count < 0) {
+        throw std::runtime_error("Cannot generate a negative number of strings");
+    }
+    std::shared_ptr<const CompiledCFG> grammar = _grammar();
+    StringBatch ret;
+    ret._offsets.reserve((size_t)count + 1);
+    // Reserve enough for the longest possible output if we know it and it isn't unreasonably large
+    long long longest = _longest(steps);
+    if(longest <= MAX_RESERVED / std::max(count, 1)) {
+        ret._characters.reserve(longest * count);
+    }
+    threads = std::max(1, std::min(threads, count));
+    if(threads == 1) {
+        generateInto(*grammar, steps, count, random, ret._characters, ret._offsets);
+        return ret;
+    }
+    // Split into contiguous parts that each get their own generator, arena and working space
+    std::vector<Random> randoms;
+    std::vector<std::string> characters(threads);
+    std::vector<std::vector<size_t>> offsets(threads);
+    uint64_t seed = random.generate64();
+    for(int i = 0; i < threads; ++i) {
+        randoms.emplace_back(seed, i);
+    }
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(threads);
+    for(int i = 0; i < threads; ++i) {
+        int partCount = count / threads + (i < count % threads);
+        workers.emplace_back([&, i, partCount]() {
+            try {
+                characters[i].reserve(ret._characters.capacity() / threads);
+                offsets[i].reserve(partCount);
+                generateInto(*grammar, steps, partCount, randoms[i], characters[i], offsets[i]);
+            } catch(...) {
+                errors[i] = std::current_exception();
             }
+        });
+    }
+    for(std::thread &worker : workers) {
+        worker.join();
+    }
+    for(std::exception_ptr error : errors) {
+        if(error) {
+            std::rethrow_exception(error);
         }
     }
-    std::string ret;
-    while(!soFar.empty()) {
-        // Append each nonterminal expansion while ignoring remaining nonterminals
-        ret += !soFar.front().empty() && soFar.front()[0] != '<' ? soFar.front() : "";
-        soFar.pop();
+    // Stitch the parts together, moving each part's offsets past the parts before it
+    size_t total = 0;
+    for(const std::string &part : characters) {
+        total += part.size();
+    }
+    ret._characters.reserve(total);
+    for(int i = 0; i < threads; ++i) {
+        size_t base = ret._characters.size();
+        ret._characters += characters[i];
+        for(size_t offset : offsets[i]) {
+            ret._offsets.push_back(base + offset);
+        }
     }
     return ret;
 }
 
+void ProbCFG::buildBanks(const std::vector<int> &steps, const int size, Random &random, const int threads) {
+    if(size <= 0) {
+        throw std::runtime_error("A pattern bank needs at least one string");
+    }
+    std::map<int, StringBatch> banks;
+    for(int bankSteps : steps) {
+        banks[bankSteps] = generateBatch(bankSteps, size, random, threads);
+    }
+    _banks = std::make_shared<const std::map<int, StringBatch>>(std::move(banks));
+}
+
+bool ProbCFG::hasBank(const int steps) const {
+    return _banks && _banks->find(steps) != _banks->end();
+}
+
+BankStatistics ProbCFG::checkBank(const int steps, const int samples, Random &random, const int threads) const {
+    if(!hasBank(steps)) {
+        throw std::runtime_error("There is no bank for " + std::to_string(steps) + " steps");
+    }
+    const StringBatch &bank = _banks->at(steps);
+    StringBatch sample = generateBatch(steps, samples, random, threads);
+    // How often each string appears in the bank and in the sample
+    std::map<std::string, std::pair<int, int>> counts;
+    for(size_t i = 0; i < bank.size(); ++i) {
+        ++counts[bank[i]].first;
+    }
+    for(size_t i = 0; i < sample.size(); ++i) {
+        ++counts[sample[i]].second;
+    }
+    BankStatistics ret;
+    ret.outcomes = (int)counts.size();
+    ret.distance = 0;
+    for(auto it = counts.begin(); it != counts.end(); ++it) {
+        ret.distance += std::abs((double)it->second.first / bank.size() -
+                                 (double)it->second.second / std::max(samples, 1));
+    }
+    ret.distance /= 2;
+    ret.tolerance = std::sqrt((double)ret.outcomes / bank.size()) +
+            std::sqrt((double)ret.outcomes / std::max(samples, 1));
+    // Compare the characters at each position the same way. '\0' stands for having run out of characters
+    ret.characterDistance = 0;
+    int mostCharacters = 1;
+    for(size_t position = 0; ; ++position) {
+        std::map<char, std::pair<int, int>> characterCounts;
+        bool anyLeft = false;
+        for(size_t i = 0; i < bank.size(); ++i) {
+            anyLeft |= position < bank.length(i);
+            ++characterCounts[position < bank.length(i) ? bank.data(i)[position] : '\0'].first;
+        }
+        for(size_t i = 0; i < sample.size(); ++i) {
+            anyLeft |= position < sample.length(i);
+            ++characterCounts[position < sample.length(i) ? sample.data(i)[position] : '\0'].second;
+        }
+        if(!anyLeft) {
+            break;
+        }
+        double distance = 0;
+        for(auto it = characterCounts.begin(); it != characterCounts.end(); ++it) {
+            distance += std::abs((double)it->second.first / bank.size() -
+                                 (double)it->second.second / std::max(samples, 1));
+        }
+        ret.characterDistance = std::max(ret.characterDistance, distance / 2);
+        mostCharacters = std::max(mostCharacters, (int)characterCounts.size());
+    }
+    ret.characterTolerance = std::sqrt((double)mostCharacters / bank.size()) +
+            std::sqrt((double)mostCharacters / std::max(samples, 1));
+    return ret;
+}
+
+CFGStream ProbCFG::stream(int steps, Random &random) const {
+    if(hasBank(steps)) {
+        const StringBatch &bank = _banks->at(steps);
+        size_t i = random.bounded((int)bank.size());
+        return CFGStream(bank.data(i), bank.data(i) + bank.length(i), _banks);
+    }
+    return CFGStream(_grammar(), steps, random);
+}
+
+void ProbCFG::stream(int steps, Random &random, CFGStream &out) const {
+    if(hasBank(steps)) {
+        const StringBatch &bank = _banks->at(steps);
+        size_t i = random.bounded((int)bank.size());
+        out.restart(bank.data(i), bank.data(i) + bank.length(i), _banks);
+    } else if(_compiled) {
+        out.restart(_compiled, steps, random);
+    } else {
+        out.restart(_grammar(), steps, random);
+    }
+}
+
+void ProbCFG::compile() {
+    if(_missing.find("<START>") != _missing.end()) {
+        throw std::runtime_error("Missing <START> nonterminal");
+    } else if(!_missing.empty()) {
+        throw std::runtime_error(*(_missing.begin)() + " appears on the right but not the left");
+    }
+    _compiled = std::make_shared<const CompiledCFG>(_rules);
+    _bounds = std::make_shared<const LengthBounds>(*_compiled, boundedSteps);
+    _banks = nullptr;
+}
+
+std::shared_ptr<const CompiledCFG> ProbCFG::compiled() const {
+    return _compiled;
+}
+
+std::shared_ptr<const LengthBounds> ProbCFG::lengthBounds() const {
+    return _bounds;
+}
+
+void ProbCFG::fromCompiled(std::shared_ptr<const CompiledCFG> compiled) {
+    _rules.clear();
+    _missing.clear();
+    _compiled = compiled;
+    _bounds = std::make_shared<const LengthBounds>(*_compiled, boundedSteps);
+    _banks = nullptr;
+}
+
 std::set<std::string> ProbCFG::missingNonterminals() const {
     return _missing;
 }
@@ -157,32 +393,31 @@ void ProbCFG::fromFile(const std::string fileName) {
     std::ifstream cfgFile;
     cfgFile.open(fileName);
     std::string rule;
+    int line = 0;
     if(cfgFile.is_open()) {
         while(getline(cfgFile, rule)) {
-            addRule(rule);
+            addRule(rule, ++line);
         }
     } else {
         throw std::runtime_error("File " + fileName + " not found");
     }
-    if(_missing.find("<START>") != _missing.end()) {
-        throw std::runtime_error("Missing <START> nonterminal");
-    } else if(!_missing.empty()) {
-        throw std::runtime_error(*(_missing.begin)() + " appears on the right but not the left");
-    }
+    compile();
 }
 
 void ProbCFG::fromFile(const std::string fileName, const std::string cfgName) {
     std::ifstream cfgFile;
     cfgFile.open(fileName);
     std::string rule;
+    int line = 0;
     if(cfgFile.is_open()) {
         bool inCFG = false;
         while(getline(cfgFile, rule)) {
+            ++line;
             if(inCFG && rule[0] == '[') {
                 break;
             }
             if(inCFG) {
-                addRule(rule);
+                addRule(rule, line);
             }
             if(rule == "[" + cfgName + "]") {
                 inCFG = true;
@@ -194,31 +429,5 @@ void ProbCFG::fromFile(const std::string fileName, const std::string cfgName) {
     } else {
         throw std::runtime_error("File " + fileName + " not found");
     }
-    if(_missing.find("<START>") != _missing.end()) {
-        throw std::runtime_error("Missing <START> nonterminal");
-    } else if(!_missing.empty()) {
-        throw std::runtime_error(*(_missing.begin)() + " appears on the right but not the left");
-    }
-}
-
-bool ProbCFG::_isValidRule(const std::string rule) const {
-    static std::string spaces = "( )*"; // 0 or more spaces
-    static std::string nonTerminal = "(<" + _nameRegexp + ">)"; // Nonterminals need are surrounded by <>
-    // A valid terminal either follows the format of `name` or is the empty std::string('`')
-    static std::string terminal = "(" + _nameRegexp + "|" + "`" + ")";
-    // The weight must have at least 1 space before it and then a number greater than 0
-    static std::string weight = "(( )+0*[1-9][0-9]*)";
-    /* The 1st expansion must be a terminal followed by a weight or a nonterminal followed by a
-     * weight */
-    static std::string expansion = "((" + nonTerminal + "|" + terminal + ")+" + weight + spaces + ")";
-    // Every subsequent expansion must be separated by an "|" with 0 or more spaces surrounding it
-    static std::string multipleExpansion = "((" + spaces + "\\|" + spaces + expansion +
-            spaces + ")" "*" ")";
-    // Tie all the rules above nicely together and make sure the whole std::string matches
-    static std::string ruleRegex = "^" + spaces + nonTerminal + spaces + "\\=" + spaces + expansion +
-            spaces + multipleExpansion + "$" + spaces;
-    // Make sure backticks are in their own rule
-    static std::string checkBackticks = "(`([A-Za-z0-9\\-\\+_<>`]+))|(([A-Za-z0-9\\-\\+_<>`]+)`)";
-    // Check if we match the regex rule and don't have any illegal backticks
-    return regex_match(rule, std::regex(ruleRegex)) && !regex_search(rule, std::regex(checkBackticks));
+    compile();
 }
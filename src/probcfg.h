@@ -21,11 +21,15 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 #include <set>
 #include <string>
 #include <map>
+#include <memory> // std::shared_ptr
 #include <stdexcept> // for runtime_error
 
-#include <QRandomGenerator>
-
 #include "weighted_vector.h"
+#include "compiledcfg.h"
+#include "lengthbounds.h"
+#include "cfgstream.h"
+#include "stringbatch.h"
+#include "random.h"
 
 /**
  * Model of a CFG for the purpose of string generation. We used a modified form of BNF.
@@ -55,6 +59,9 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
  * warning. If we have completed the number of required steps and still have nonterminals in our
  * expression, we replace all nonterminals with the empty string. No warning is printed
  *
+ * Generation runs on a CompiledCFG built by compile(). fromFile compiles automatically once every
+ * rule has been read. Adding a rule discards the compiled form
+ *
  * An invalid CFG would be:
  * <1> = <3> | <5>& 15 % The first expansion has no weight and the second has an illegal character
  * <3> = dddd15| <5> 10 % The first expansion needs a space before its weight
@@ -62,13 +69,108 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
  * <happy birthday> = the 15 % Space is not a valid character in names
  */
 
+/// How closely a pattern bank(see ProbCFG::buildBanks) matches the CFG it was sampled from
+struct BankStatistics {
+    /// The number of distinct strings seen in the bank and the independent sample together
+    int outcomes;
+
+    /// The total variation distance between the bank and an independent sample of the CFG
+    double distance;
+
+    /**
+     * How far apart two samples of the same distribution can be expected to be: the sum over both
+     * samples of sqrt(outcomes / sample size). Once there are more outcomes than strings this is above
+     * 1 and distance says little, which is what the per character statistics below are for
+     */
+    double tolerance;
+
+    /**
+     * The largest total variation distance between the bank and the sample of the distribution of the
+     * character at any one position(with strings that are too short counting as one more character)
+     */
+    double characterDistance;
+
+    /// tolerance for characterDistance, using the most distinct characters at any one position
+    double characterTolerance;
+};
+
 class ProbCFG {
 public:
-    /// Add a single rule to our cfg
+    /**
+     * Add a single rule to our cfg. Throws an error giving the column of the first offending
+     * character if the rule is in the wrong format
+     */
     void addRule(const std::string rule);
 
-    /// Generate a string from stepping through our CFG `steps` steps
-    std::string generateString(int steps);
+    /// Add a single rule that was read from line number `line` of a file. Errors include the line
+    void addRule(std::string rule, const int line);
+
+    /// The most steps lengthBounds() covers
+    static constexpr int boundedSteps = 256;
+
+    /**
+     * Generate a string from stepping through our CFG `steps` steps drawing choices from `random`. If we
+     * are compiled and `steps` is at most boundedSteps the string is reserved up front for the longest
+     * output our rules allow, so it never grows
+     */
+    std::string generateString(int steps, Random &random) const;
+
+    /**
+     * Generate `count` strings from our rules(never from a bank) into one StringBatch. The
+     * working space is shared between every string and the batch's characters are reserved up front
+     * like generateString's, so nothing is allocated per string.
+     * With `threads` > 1 the batch is split into that many contiguous parts generated at once. Each
+     * part draws from its own Random seeded from `random`, so a batch is reproducible for the same
+     * state of `random` and the same number of threads
+     */
+    StringBatch generateBatch(int steps, int count, Random &random, int threads = 1) const;
+
+    /**
+     * Pre-generate a bank of `size` strings for each step count in `steps`, splitting the work across
+     * `threads` threads. Afterwards generateString and stream for one of those step counts return a
+     * string from the bank picked with a single draw from `random` instead of expanding our rules.
+     * The banks are shared between copies. Adding rules, compiling or replacing our rules discards them
+     */
+    void buildBanks(const std::vector<int> &steps, const int size, Random &random, const int threads = 1);
+
+    /// Return true if we have a bank for `steps` steps
+    bool hasBank(const int steps) const;
+
+    /**
+     * Compare our bank for `steps` steps with `samples` strings freshly generated from our rules and
+     * return how far apart they are. Throws an error if we have no such bank
+     */
+    BankStatistics checkBank(const int steps, const int samples, Random &random, const int threads = 1) const;
+
+    /**
+     * Return a stream over the string generateString(`steps`, `random`) would return that only expands
+     * our CFG as its characters are read. `random` must outlive the stream
+     */
+    CFGStream stream(int steps, Random &random) const;
+
+    /// Restart `out` as stream(`steps`, `random`) would return it, reusing its memory
+    void stream(int steps, Random &random, CFGStream &out) const;
+
+    /**
+     * Build the compiled form of our rules that generation uses. Throws an error if we have no
+     * <START> rule or have unmatched nonterminals
+     */
+    void compile();
+
+    /// Return our compiled form or nullptr if we've added rules since we last compiled
+    std::shared_ptr<const CompiledCFG> compiled() const;
+
+    /**
+     * Return the bounds on our output's length for up to boundedSteps steps, worked out once when we were
+     * compiled, or nullptr if we've added rules since we last compiled
+     */
+    std::shared_ptr<const LengthBounds> lengthBounds() const;
+
+    /**
+     * Replace our rules with an already compiled CFG(for example one from a .stylec file). rules() is
+     * empty afterwards since only the compiled form is kept
+     */
+    void fromCompiled(std::shared_ptr<const CompiledCFG> compiled);
 
     /**
      * Returns a set containing every nonterminal that appears in the right side of a rule
@@ -94,11 +196,16 @@ public:
      */
     void fromFile(const std::string fileName, const std::string cfgName);
 private:
+    /* Return our compiled form or, if rules were added since we last compiled, a throwaway compiled copy.
+     * Throws an error if we have no <START> rule or have unmatched nonterminals */
+    std::shared_ptr<const CompiledCFG> _grammar() const;
+
     // Remove anything after a '%' sign. Returns true if there's still non-whitespace in our string
     bool _removeComments(std::string &rule) const;
 
-    // Make sure `rule` is a valid rule string for our cfg. Assumes comments have been removed
-    bool _isValidRule(const std::string rule) const;
+    // Return the longest output `steps` steps can generate or LengthBounds::unbounded if we don't know it
+    long long _longest(const int steps) const;
+
 
     /* A map with nonterminals as keys and a weighted vector containing its expansions and
      * corresponding weights */
@@ -107,8 +214,14 @@ private:
     // A set containing all our unpaired nonterminals
     std::set<std::string> _missing = {"<START>"};
 
-    // Regex rule for valid nonterminal name and for valid non-empty terminal string
-    const std::string _nameRegexp = "([A-Za-z0-9\\-\\+_]+)";
+    // The compiled form of _rules. Shared between copies since it is never modified once built
+    std::shared_ptr<const CompiledCFG> _compiled;
+
+    // The length bounds of _compiled. Shared for the same reason
+    std::shared_ptr<const LengthBounds> _bounds;
+
+    // Pre-generated strings keyed by their number of steps. Shared for the same reason
+    std::shared_ptr<const std::map<int, StringBatch>> _banks;
 };
 
 #endif // PROBCFG_H
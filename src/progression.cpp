@@ -0,0 +1,53 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdlib> // std::strtol
+#include <algorithm> // std::max
+#include <stdexcept> // std::runtime_error
+
+#include "progression.h"
+#include "chord.h"
+
+std::vector<comper::quarterNoteChord> comper::readProgression(const std::string &fileName, const int repetitions,
+        const int velocity) {
+    std::ifstream file(fileName);
+    if(!file.is_open()) {
+        throw std::runtime_error("File " + fileName + " not found");
+    }
+    std::vector<quarterNoteChord> progression;
+    std::string line;
+    while(getline(file, line)) {
+        quarterNoteChord chord(line.substr(0, line.find_last_of(' ')));
+        chord.setDuration(std::strtol(line.substr(line.find_last_of(' ') + 1).c_str(), nullptr, 10));
+        chord.setVelocity(velocity);
+        progression.push_back(chord);
+    }
+    if(repetitions < 1) {
+        return {};
+    }
+    size_t chords = progression.size();
+    progression.reserve(chords * repetitions);
+    for(int i = 1; i < repetitions; ++i) {
+        for(size_t j = 0; j < chords; ++j) {
+            progression.push_back(progression[j]);
+        }
+    }
+    return progression;
+}
@@ -0,0 +1,38 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROGRESSION_H
+#define PROGRESSION_H
+#include <vector>
+#include <string>
+
+#include "chord.h"
+
+namespace comper {
+    /// Identical to regular Chord object but its duration represents duration in quarter notes
+    typedef Chord quarterNoteChord;
+
+    /**
+     * Read the progression in `fileName` and repeat it `repetitions` times, or return nothing if
+     * `repetitions` is less than 1. Each line is a chord name followed by a space and its duration in
+     * quarter notes. Every chord gets velocity `velocity`. Each chord name is only parsed once however many
+     * times the progression repeats. Throws an error if the file can't be opened
+     */
+    std::vector<quarterNoteChord> readProgression(const std::string &fileName, const int repetitions,
+            const int velocity = 100);
+}
+#endif // PROGRESSION_H
@@ -0,0 +1,132 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef RANDOM_H
+#define RANDOM_H
+#include <cstdint>
+
+#include <QRandomGenerator>
+
+/**
+ * A seedable xoshiro256** random number generator. Every generation context owns one of these so
+ * generation needs no shared state: threads never contend over a generator and the same seed always
+ * reproduces the same output. Different stream numbers with the same seed give independent streams,
+ * so one seed can drive several threads or several parts of a backing track.
+ * Satisfies UniformRandomBitGenerator so it can also be used with <random>
+ * @cite https://prng.di.unimi.it/
+ */
+class Random {
+public:
+    typedef uint64_t result_type;
+
+    /// Seed from the operating system's entropy source
+    Random() : Random(QRandomGenerator::system()->generate64()) {}
+
+    /**
+     * Seed with `seed`. Each `stream` gives a different, independent sequence for the same seed: stream n
+     * starts jump() n times further along than stream 0, so streams of one seed never overlap. Every stream
+     * costs a jump to set up, so stream numbers are meant to be small, like a thread or track number
+     */
+    Random(const uint64_t seed, const uint64_t stream = 0) {
+        // Expand the seed into the full state with splitmix64 as recommended
+        uint64_t mixed = seed;
+        for(uint64_t &word : _state) {
+            mixed += 0x9e3779b97f4a7c15;
+            word = _splitmix(mixed);
+        }
+        for(uint64_t i = 0; i < stream; ++i) {
+            jump();
+        }
+    }
+
+    /// Skip ahead 2^128 numbers, as if generate64 had been called that many times
+    void jump() {
+        static const uint64_t polynomial[] = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa,
+                                              0x39abdc4529b1661c};
+        uint64_t jumped[4] = {0, 0, 0, 0};
+        for(uint64_t word : polynomial) {
+            for(int bit = 0; bit < 64; ++bit) {
+                if(word & (uint64_t)1 << bit) {
+                    for(int i = 0; i < 4; ++i) {
+                        jumped[i] ^= _state[i];
+                    }
+                }
+                generate64();
+            }
+        }
+        for(int i = 0; i < 4; ++i) {
+            _state[i] = jumped[i];
+        }
+    }
+
+    /// Return the next 64 random bits
+    uint64_t generate64() {
+        uint64_t ret = _rotate(_state[1] * 5, 7) * 9;
+        uint64_t shifted = _state[1] << 17;
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= shifted;
+        _state[3] = _rotate(_state[3], 45);
+        return ret;
+    }
+
+    /**
+     * Return a uniformly distributed number in [0, `highest`). `highest` must be greater than 0
+     * @cite https://arxiv.org/abs/1805.10941
+     */
+    int bounded(const int highest) {
+        uint32_t range = highest;
+        uint64_t product = (generate64() >> 32) * range;
+        if((uint32_t)product < range) {
+            // Reject the few values that would make the result biased
+            uint32_t threshold = -range % range;
+            while((uint32_t)product < threshold) {
+                product = (generate64() >> 32) * range;
+            }
+        }
+        return (int)(product >> 32);
+    }
+
+    uint64_t operator()() {
+        return generate64();
+    }
+
+    static constexpr uint64_t min() {
+        return 0;
+    }
+
+    static constexpr uint64_t max() {
+        return UINT64_MAX;
+    }
+
+private:
+    static uint64_t _rotate(const uint64_t x, const int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    static uint64_t _splitmix(uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+        return x ^ (x >> 31);
+    }
+
+    uint64_t _state[4];
+};
+
+#endif // RANDOM_H
@@ -25,15 +25,14 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 #include "chord.h"
 #include "midiwriter.h"
 #include "note.h"
+#include "notevalue.h"
 #include "probcfg.h"
+#include "progression.h" // comper::quarterNoteChord
 #include "note_numbers.h"
 #include "bassutils.h"
+#include "random.h"
 
 namespace comper {
-    std::vector<int> scaleTones = {1, 2, 3, 4, 5, 6, 7};
-    std::vector<int> chordTones = {1, 3, 5, 7};
-    /// Identical to regular Chord object but its duration represents duration in quarter notes
-    typedef Chord quarterNoteChord;
     /**
      * @param `progression` A vector of quarterNoteChords representing the chord progression
      * @param `patternCFG` A ProbCFG that can generate a pattern. 
@@ -47,57 +46,90 @@ namespace comper {
      *  This does not guarantee that the bassline will never go below this note, but rather, that it will
      *  start moving in the opposite direction the moment it goes past this note.
      * @param highestNote the highest our bassline will go before turning around. Opposite of lowestNote
+     * @param random where every random choice is drawn from. The same state always gives the same bassline
      * @param velocity the velocity of each note in the bassline
      *
      * Generatess a vector of Notes representing a walking bassline. Generates a new pattern for each chord
      * and follows the pattern till it reaches the last beat of the chord at which point it finds the closest
      * leading note to the next root. Then it plays the closest root. Note that the root won't necessarily
-     * follow the directions instruction nor will it necessarily follow highestNote nor lowestNote
+     * follow the directions instruction nor will it necessarily follow highestNote nor lowestNote.
+     * Everything but the returned Notes is reused from call to call on the same thread, so once it has
+     * grown big enough nothing else is allocated
      */
-    std::vector<Note> genSimpleWalkingBassline(std::vector<quarterNoteChord> progression, ProbCFG patternCFG,
-            ProbCFG directionCFG, Note lowestNote, Note highestNote, int velocity = 100) {
+    std::vector<Note> genSimpleWalkingBassline(const std::vector<quarterNoteChord> &progression,
+            const ProbCFG &patternCFG, const ProbCFG &directionCFG, const Note lowestNote,
+            const Note highestNote, Random &random, int velocity = 100) {
         if(lowestNote > highestNote) {
             throw std::runtime_error("LowestNote should be below highestNote");
         }
-        std::vector<Note> bassline;
-        Note prev;
-        // Make sure at the end we have somewhere to lead to
-        progression.push_back(progression[0]);
-        for(auto it = progression.begin(); it < progression.end() - 1; ++it) {
-            Chord currentChord = *it;
-            // Generate a pattern for the current chord and the direction of each note's travel
-            std::string pattern = patternCFG.generateString(currentChord.duration());
-            std::string directions = directionCFG.generateString(currentChord.duration());
-            if(pattern.size() < (size_t)currentChord.duration() - 1 ||
-                    directions.size() < (size_t)currentChord.duration() - 1) {
-                throw std::runtime_error("One of the provided CFGs produced output that was too short");
+        // The line is worked out as values and only turned into Notes at the end
+        thread_local std::vector<NoteValue> bassline;
+        bassline.clear();
+        int totalDuration = 0;
+        for(const quarterNoteChord &chord : progression) {
+            totalDuration += chord.duration();
+        }
+        bassline.reserve(totalDuration + 1);
+        NoteValue prev;
+        const NoteValue lowest = lowestNote.value(), highest = highestNote.value();
+        /* The streams and forced directions are reused from chord to chord and call to call so nothing is
+         * allocated once they have grown big enough */
+        thread_local CFGStream pattern, directions;
+        /* Directions forced by going out of range are read before the rest of the generated
+         * directions. Stored in reverse so the next one is at the back */
+        thread_local std::string forcedDirections;
+        auto nextDirection = []() {
+            if(forcedDirections.empty()) {
+                return directions.next();
             }
+            char direction = forcedDirections.back();
+            forcedDirections.pop_back();
+            return direction;
+        };
+        for(size_t chord = 0; chord < progression.size(); ++chord) {
+            const ChordValue currentChord = progression[chord].value();
+            // The tones the 'A', 'C', 'F', and 'S' patterns step through are looked up in the interned chord
+            const ChordSymbol &symbol = progression[chord].symbol();
+            const int root = currentChord.root().pitchClass();
+            // Make sure at the end we have somewhere to lead to
+            const ChordValue nextChord = progression[(chord + 1) % progression.size()].value();
+            // Stream a pattern for the current chord and the direction of each note's travel
+            patternCFG.stream(currentChord.duration(), random, pattern);
+            directionCFG.stream(currentChord.duration(), random, directions);
+            forcedDirections.clear();
             // Generate a note for each beat
             for(int i = 0; i < currentChord.duration() - 1; ++i) {
+                char curr = pattern.next();
+                if(curr == '\0') {
+                    throw std::runtime_error("One of the provided CFGs produced output that was too short");
+                }
                 // Begin with the first root in the progression between the limit notes.
                 if(bassline.empty()) {
-                    Note start = currentChord.bass();
-                    start.setOctave((lowestNote.octave() + highestNote.octave()) / 2);
-                    start.setVelocity(velocity);
-                    start.setDuration(4);
+                    nextDirection();
+                    NoteValue start = currentChord.bass()
+                            .withOctave((lowestNote.octave() + highestNote.octave()) / 2)
+                            .withVelocity(velocity).withDuration(4);
                     bassline.push_back(start);
                     prev = start;
                     continue;
                 }
                 prev = *(bassline.rbegin());
-                char curr = pattern[i];
                 // If we go too high or too low, turn around
-                if(prev.number() > highestNote.number()) {
-                    directions.insert(i, "DDDD");
-                } else if(prev.number() < lowestNote.number()) {
-                    directions.insert(i, "UUUU");
+                if(prev > highest) {
+                    forcedDirections += "DDDD";
+                } else if(prev < lowest) {
+                    forcedDirections += "UUUU";
+                }
+                char direction = nextDirection();
+                if(direction == '\0') {
+                    throw std::runtime_error("One of the provided CFGs produced output that was too short");
                 }
-                Direction dir = (Direction)(directions[i] == 'U');
+                Direction dir = (Direction)(direction == 'U');
                 if(isdigit(curr)) {
                     if(curr - '0' == '9') {
                         throw std::runtime_error("can only have the digits 0-8");
                     }
-                    Note tone = prev.closest(currentChord.notes()[curr - '0'].name());
+                    NoteValue tone = prev.closest(currentChord.note(curr - '0').pitchClass());
                     // if we're close, push back the closest, otherwise follow direction
                     if(tone - prev <= 2) {
                         bassline.push_back(tone);
@@ -106,13 +138,10 @@ namespace comper {
                     }
                 } else if(curr == 'A' || curr == 'C' || curr == 'F') {
                     // play the next chord tone
-                    currentChord.setVoicing(chordTones);
-                    bassline.push_back(nthClosestChordTone(prev, currentChord, dir, curr == 'F' ?
-                                                               2 : 1));
+                    bassline.push_back(nthClosestChordTone(prev, symbol.chordTones, root, dir, curr == 'F' ? 2 : 1));
                 } else if(curr == 'S') {
                     // play the next scale tone
-                    currentChord.setVoicing(scaleTones);
-                    bassline.push_back(closestChordTone(prev, currentChord, dir));
+                    bassline.push_back(closestChordTone(prev, symbol.scaleTones, root, dir));
                 } else if(curr == 'O') {
                     // jump an octave
                     bassline.push_back(dir ? prev + NUM_NOTES : prev + -NUM_NOTES);
@@ -123,13 +152,12 @@ namespace comper {
                     throw std::runtime_error("Illegal character in CFG");
                 }
             }
-            bassline.push_back(closestLeadingNote(*(bassline.rbegin()), (it + 1)->bass(), currentChord,
-                        (Direction)(directions[currentChord.duration() - 1] == 'U')));
+            bassline.push_back(closestLeadingNote(*(bassline.rbegin()), nextChord.bass(), currentChord,
+                        (Direction)(nextDirection() == 'U')));
         }
-        Note finalNote = bassline[0];
-        finalNote.setDuration(1);
-        bassline.push_back(finalNote);
-        return bassline;
+        bassline.push_back(bassline[0].withDuration(1));
+        // Names are only spelled if someone asks for them
+        return std::vector<Note>(bassline.begin(), bassline.end());
     }
 } // comper
 #endif
@@ -0,0 +1,68 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef STRINGBATCH_H
+#define STRINGBATCH_H
+#include <vector>
+#include <string>
+#include <cstddef> // size_t
+
+/**
+ * Many strings stored back to back in one block of characters. String i is the characters from
+ * offset i up to offset i + 1, so a batch of n strings holds n + 1 offsets and only ever needs two
+ * allocations no matter how many strings it holds
+ */
+class StringBatch {
+public:
+    /// Return the number of strings in the batch
+    size_t size() const {
+        return _offsets.size() - 1;
+    }
+
+    /// Return a pointer to the characters of string number `i`. They are not null terminated
+    const char *data(const size_t i) const {
+        return _characters.data() + _offsets[i];
+    }
+
+    /// Return the number of characters in string number `i`
+    size_t length(const size_t i) const {
+        return _offsets[i + 1] - _offsets[i];
+    }
+
+    /// Return a copy of string number `i`
+    std::string operator[](const size_t i) const {
+        return _characters.substr(_offsets[i], length(i));
+    }
+
+    /// Return every string's characters back to back
+    const std::string &characters() const {
+        return _characters;
+    }
+
+    /// Return where each string starts in characters() followed by the total number of characters
+    const std::vector<size_t> &offsets() const {
+        return _offsets;
+    }
+
+private:
+    friend class ProbCFG;
+
+    std::string _characters;
+    std::vector<size_t> _offsets = {0};
+};
+
+#endif // STRINGBATCH_H
@@ -0,0 +1,133 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory> // std::shared_ptr
+#include <fstream>
+#include <stdexcept> // std::runtime_error
+
+#include "stylebundle.h"
+#include "probcfg.h"
+#include "compiledstyle.h"
+#include "random.h"
+
+void StyleBundle::fromFile(const std::string fileName) {
+    fromFile(fileName, StyleBundle());
+}
+
+void StyleBundle::fromFile(const std::string fileName, const StyleBundle &previous) {
+    if(CompiledStyle::isCompiledStyle(fileName)) {
+        // Every section is already compiled so just point at the tables in the mapped file
+        CompiledStyle compiled(fileName);
+        for(int i = 0; i < compiled.sectionCount(); ++i) {
+            std::shared_ptr<ProbCFG> cfg = std::make_shared<ProbCFG>();
+            cfg->fromCompiled(compiled.section(i));
+            _cfgs[compiled.sectionName(i)] = cfg;
+        }
+        return;
+    }
+    std::ifstream styleFile(fileName);
+    if(!styleFile.is_open()) {
+        throw std::runtime_error("File " + fileName + " not found");
+    }
+    std::string line;
+    int lineNumber = 0;
+    std::string name;
+    bool inSection = false;
+    // The current section's text and the line number it starts at
+    std::string source;
+    int firstLine = 0;
+    // Parse and compile the section we just finished reading, unless it hasn't changed, and publish it
+    auto finishSection = [this, &previous, &name, &inSection, &source, &firstLine]() {
+        if(!inSection) {
+            return;
+        }
+        auto old = previous._sources.find(name);
+        if(old != previous._sources.end() && old->second == source) {
+            _cfgs[name] = previous._cfgs.at(name);
+            _sources[name] = source;
+            return;
+        }
+        std::shared_ptr<ProbCFG> cfg = std::make_shared<ProbCFG>();
+        int ruleLine = firstLine;
+        size_t begin = 0;
+        try {
+            while(begin < source.size()) {
+                size_t end = source.find('\n', begin);
+                cfg->addRule(source.substr(begin, end - begin), ruleLine++);
+                begin = end + 1;
+            }
+            cfg->compile();
+        } catch(const std::runtime_error &error) {
+            throw std::runtime_error(std::string(error.what()) + " in [" + name + "]");
+        }
+        _cfgs[name] = cfg;
+        _sources[name] = source;
+    };
+    while(getline(styleFile, line)) {
+        ++lineNumber;
+        if(!line.empty() && line[0] == '[') {
+            finishSection();
+            // The name is everything between the brackets. Anything after the ']' is ignored
+            name = line.substr(1, line.find(']') - 1);
+            if(line.find(']') == line.npos || _cfgs.find(name) != _cfgs.end()) {
+                throw std::runtime_error("Invalid or repeated section [" + name + "] at line " +
+                                         std::to_string(lineNumber));
+            }
+            inSection = true;
+            source.clear();
+            firstLine = lineNumber + 1;
+        } else if(inSection) {
+            source += line + '\n';
+        }
+    }
+    finishSection();
+}
+
+const ProbCFG &StyleBundle::operator[](const std::string name) const {
+    auto it = _cfgs.find(name);
+    if(it == _cfgs.end()) {
+        throw std::runtime_error("Could not find CFG [" + name + "] in style");
+    }
+    return *(it->second);
+}
+
+std::shared_ptr<const ProbCFG> StyleBundle::cfg(const std::string name) const {
+    auto it = _cfgs.find(name);
+    return it == _cfgs.end() ? nullptr : it->second;
+}
+
+void StyleBundle::buildBanks(const std::string name, const std::vector<int> &steps, const int size,
+                             Random &random, const int threads) {
+    std::shared_ptr<ProbCFG> banked = std::make_shared<ProbCFG>((*this)[name]);
+    banked->buildBanks(steps, size, random, threads);
+    _cfgs[name] = banked;
+}
+
+bool StyleBundle::contains(const std::string name) const {
+    return _cfgs.find(name) != _cfgs.end();
+}
+
+std::vector<std::string> StyleBundle::names() const {
+    std::vector<std::string> ret;
+    for(auto it = _cfgs.begin(); it != _cfgs.end(); ++it) {
+        ret.push_back(it->first);
+    }
+    return ret;
+}
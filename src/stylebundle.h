@@ -0,0 +1,79 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef STYLEBUNDLE_H
+#define STYLEBUNDLE_H
+#include <string>
+#include <vector>
+#include <map>
+#include <memory> // std::shared_ptr
+
+#include "probcfg.h"
+#include "random.h"
+
+/**
+ * Every CFG of a style file(see style.md) read in a single pass. Each line starting with '[' begins
+ * the section named between the brackets and every rule up to the next such line belongs to it.
+ * Lines before the first section are ignored. Any number of sections with any names is allowed.
+ * Precompiled .stylec files(see CompiledStyle) are also accepted and used without any parsing.
+ *
+ * Each section's ProbCFG is compiled as soon as it is read and never modified afterwards, so a
+ * bundle(or any of its CFGs) can be shared between any number of concurrent generations.
+ */
+class StyleBundle {
+public:
+    /**
+     * Read every section of `fileName` and add it to our bundle. Throws an error if a section is
+     * invalid or appears twice
+     */
+    void fromFile(const std::string fileName);
+
+    /**
+     * Read every section of `fileName` like fromFile(`fileName`) but reuse the CFG of any section whose
+     * text is the same as in `previous` instead of parsing and compiling it again
+     */
+    void fromFile(const std::string fileName, const StyleBundle &previous);
+
+    /// Return the CFG of section [`name`]. Throws an error if there is no such section
+    const ProbCFG &operator[](const std::string name) const;
+
+    /// Return a shared pointer to the CFG of section [`name`] or nullptr if there is no such section
+    std::shared_ptr<const ProbCFG> cfg(const std::string name) const;
+
+    /**
+     * Give section [`name`] pattern banks(see ProbCFG::buildBanks). The section is replaced by a copy
+     * with banks so anyone still holding the old CFG is unaffected. Throws an error if there is no
+     * such section
+     */
+    void buildBanks(const std::string name, const std::vector<int> &steps, const int size, Random &random,
+                    const int threads = 1);
+
+    /// Return true if we have a section named [`name`]
+    bool contains(const std::string name) const;
+
+    /// Return the names of all of our sections in alphabetical order
+    std::vector<std::string> names() const;
+
+private:
+    // Each section's name and its CFG
+    std::map<std::string, std::shared_ptr<const ProbCFG>> _cfgs;
+
+    // The text each section was read from. Empty for sections read from a .stylec file
+    std::map<std::string, std::string> _sources;
+};
+
+#endif // STYLEBUNDLE_H
@@ -0,0 +1,189 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <memory> // std::shared_ptr
+#include <atomic>
+#include <utility> // std::move
+#include <stdexcept> // std::runtime_error
+
+#include <dirent.h> // opendir
+#include <poll.h> // poll
+#include <sys/inotify.h> // inotify_init1
+#include <unistd.h> // read, close
+
+#include "stylecache.h"
+#include "stylebundle.h"
+
+static_assert(std::atomic<int>::is_always_lock_free &&
+              std::atomic<const std::shared_ptr<const StyleCache::Snapshot> *>::is_always_lock_free,
+              "Reading a StyleCache should never take a lock");
+
+// Return true if `fileName` looks like a style file
+bool isStyleFile(const std::string &fileName) {
+    auto endsWith = [&fileName](const std::string &suffix) {
+        return fileName.size() >= suffix.size() &&
+                fileName.compare(fileName.size() - suffix.size(), suffix.size(), suffix) == 0;
+    };
+    return endsWith(".style") || endsWith(".stylec");
+}
+
+// Return true if `fileName` looks like a style file that is read as text rather than mapped
+bool isSourceStyleFile(const std::string &fileName) {
+    return fileName.size() >= 6 && fileName.compare(fileName.size() - 6, 6, ".style") == 0;
+}
+
+StyleCache::StyleCache(const std::string directory)
+        : _directory(directory), _current(nullptr), _epoch(0), _readers{{0}, {0}} {
+    _inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    // Files are only reloaded once they've been completely written or moved into place
+    if(_inotify < 0 || inotify_add_watch(_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO |
+                                         IN_MOVED_FROM | IN_DELETE) < 0) {
+        if(_inotify >= 0) {
+            close(_inotify);
+        }
+        throw std::runtime_error("Could not watch directory " + directory);
+    }
+    std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>();
+    DIR *styleDirectory = opendir(directory.c_str());
+    if(styleDirectory) {
+        while(dirent *entry = readdir(styleDirectory)) {
+            if(isStyleFile(entry->d_name)) {
+                try {
+                    _load(*snapshot, entry->d_name);
+                } catch(const std::runtime_error &) {
+                    // Left out until it is fixed
+                }
+            }
+        }
+        closedir(styleDirectory);
+    }
+    _publish(snapshot);
+}
+
+StyleCache::~StyleCache() {
+    close(_inotify);
+    delete _current.load();
+    for(const std::shared_ptr<const Snapshot> *snapshot : _waiting) {
+        delete snapshot;
+    }
+    for(const std::shared_ptr<const Snapshot> *snapshot : _draining) {
+        delete snapshot;
+    }
+}
+
+std::shared_ptr<const StyleCache::Snapshot> StyleCache::snapshot() const {
+    // While we're counted update() won't free the snapshot we load, even if it replaces it
+    std::atomic<int> &readers = _readers[_epoch.load() & 1];
+    readers.fetch_add(1);
+    std::shared_ptr<const Snapshot> ret = *_current.load();
+    readers.fetch_sub(1);
+    return ret;
+}
+
+std::shared_ptr<const StyleBundle> StyleCache::style(const std::string fileName) const {
+    std::shared_ptr<const Snapshot> current = snapshot();
+    auto it = current->find(fileName);
+    return it == current->end() ? nullptr : it->second;
+}
+
+std::vector<std::string> StyleCache::update(const int timeoutMilliseconds) {
+    pollfd events = {_inotify, POLLIN, 0};
+    int ready = poll(&events, 1, timeoutMilliseconds);
+    // Free whatever the readers held up last time
+    _reclaim();
+    if(ready <= 0) {
+        return {};
+    }
+    // Gather every file that changed. An editor saving a file can produce several events for it
+    std::set<std::string> changed;
+    alignas(inotify_event) char buffer[4096];
+    ssize_t size;
+    while((size = read(_inotify, buffer, sizeof(buffer))) > 0) {
+        for(char *it = buffer; it < buffer + size; ) {
+            inotify_event *event = (inotify_event *)it;
+            // .stylec files are mapped, so only ones moved into place(see stylecache.h) are reloaded
+            bool rewritten = (event->mask & IN_CLOSE_WRITE) && !isSourceStyleFile(event->name);
+            if(event->len > 0 && isStyleFile(event->name) && !rewritten) {
+                changed.insert(event->name);
+            }
+            it += sizeof(inotify_event) + event->len;
+        }
+    }
+    if(changed.empty()) {
+        return {};
+    }
+    // Readers keep using the old snapshot while we build the new one
+    std::shared_ptr<Snapshot> next = std::make_shared<Snapshot>(*snapshot());
+    std::vector<std::string> errors;
+    for(const std::string &fileName : changed) {
+        if(access((_directory + "/" + fileName).c_str(), F_OK) != 0) {
+            next->erase(fileName);
+            continue;
+        }
+        try {
+            _load(*next, fileName);
+        } catch(const std::runtime_error &error) {
+            errors.push_back(fileName + ": " + error.what());
+        }
+    }
+    _publish(next);
+    return errors;
+}
+
+void StyleCache::_publish(const std::shared_ptr<const Snapshot> &snapshot) {
+    const std::shared_ptr<const Snapshot> *previous =
+            _current.exchange(new std::shared_ptr<const Snapshot>(snapshot));
+    if(previous) {
+        _waiting.push_back(previous);
+    }
+    _reclaim();
+}
+
+void StyleCache::_reclaim() {
+    for(int advanced = 0; advanced < 2; ++advanced) {
+        /* Readers count themselves in the epoch they saw before loading _current. A snapshot in _draining
+         * was replaced during epoch E - 1, so only readers counted in E - 1 or earlier could have loaded it,
+         * and everyone counted in E - 2 was gone before the epoch moved on to E. E - 1 shares a counter
+         * with E + 1, so once that counter is 0 they can be freed: anyone counting themselves in it from now
+         * on loads _current after it stopped pointing at any of them. Snapshots replaced during E wait */
+        const unsigned epoch = _epoch.load();
+        if(_readers[(epoch + 1) & 1].load() != 0) {
+            return;
+        }
+        for(const std::shared_ptr<const Snapshot> *retired : _draining) {
+            delete retired;
+        }
+        _draining = std::move(_waiting);
+        _waiting.clear();
+        _epoch.store(epoch + 1);
+    }
+}
+
+void StyleCache::_load(Snapshot &snapshot, const std::string fileName) const {
+    std::shared_ptr<StyleBundle> style = std::make_shared<StyleBundle>();
+    auto previous = snapshot.find(fileName);
+    if(previous != snapshot.end()) {
+        style->fromFile(_directory + "/" + fileName, *(previous->second));
+    } else {
+        style->fromFile(_directory + "/" + fileName);
+    }
+    snapshot[fileName] = style;
+}
@@ -0,0 +1,111 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef STYLECACHE_H
+#define STYLECACHE_H
+#include <string>
+#include <vector>
+#include <map>
+#include <memory> // std::shared_ptr
+#include <atomic>
+
+#include "stylebundle.h"
+
+/**
+ * Every style file(.style or .stylec) in a directory, kept up to date as the files change. Linux only
+ * since it uses inotify.
+ *
+ * The styles are published as one immutable snapshot behind a std::shared_ptr. Readers never take a lock:
+ * the current snapshot is reached through an atomic pointer, and a reader only counts itself in the
+ * counter of the current epoch while it copies the shared_ptr. A replaced pointer is freed two epochs
+ * later, once nobody is counted in an epoch that could have seen it. The epoch moves on whenever the
+ * previous one has no readers left, checked every time update() returns, so a reader that was busy
+ * during one reload only holds up freeing until the next poll. A reader keeps using the snapshot(and the
+ * CFGs in it) it copied for as long as it holds on to it, however many times the styles are reloaded
+ * meanwhile.
+ * update() builds a new snapshot from the old one and atomically swaps it in. Only the files that
+ * changed are read again and only the sections whose text changed are parsed and compiled again, so
+ * unchanged sections keep the same ProbCFG. A file that fails to load keeps its previous version.
+ *
+ * .stylec files are used in place from a memory mapping, so they must be replaced atomically: written
+ * somewhere else and renamed into the directory, which is what --compile-style does. They are only
+ * reloaded when one is moved into place. Rewriting one in place would change it under every snapshot
+ * still using it.
+ */
+class StyleCache {
+public:
+    /// Every style file in the directory keyed by its file name
+    typedef std::map<std::string, std::shared_ptr<const StyleBundle>> Snapshot;
+
+    /**
+     * Load every style file in `directory` and start watching it. Throws an error if the directory can't
+     * be watched. Files that fail to load are left out
+     */
+    StyleCache(const std::string directory);
+
+    ~StyleCache();
+
+    // We own the inotify descriptor so we can't be copied
+    StyleCache(const StyleCache &) = delete;
+    StyleCache &operator=(const StyleCache &) = delete;
+
+    /// Return the current snapshot. Safe to call from any thread at any time
+    std::shared_ptr<const Snapshot> snapshot() const;
+
+    /**
+     * Return the current version of style file `fileName`(a name within our directory) or nullptr if
+     * there is no such style. Safe to call from any thread at any time
+     */
+    std::shared_ptr<const StyleBundle> style(const std::string fileName) const;
+
+    /**
+     * Wait up to `timeoutMilliseconds`(-1 waits forever) for style files to change, then reload every
+     * one that changed and publish a new snapshot. Returns an error message for every file that failed
+     * to load. Replaced snapshots no reader can still be copying are freed whether or not anything
+     * changed. Must only be called from one thread at a time
+     */
+    std::vector<std::string> update(const int timeoutMilliseconds);
+
+private:
+    // Load `fileName` into `snapshot`, reusing whatever sections it can from its previous version
+    void _load(Snapshot &snapshot, const std::string fileName) const;
+
+    // Make `snapshot` the current one and free every replaced one no reader can still be copying
+    void _publish(const std::shared_ptr<const Snapshot> &snapshot);
+
+    // Move on as many epochs as the readers allow, at most two, freeing _draining each time
+    void _reclaim();
+
+    std::string _directory;
+
+    // Our inotify instance
+    int _inotify;
+
+    // The current snapshot. Readers copy what it points to while they are counted in _readers
+    std::atomic<const std::shared_ptr<const Snapshot> *> _current;
+
+    // The current epoch and the number of readers counted in even and odd epochs
+    std::atomic<unsigned> _epoch;
+    mutable std::atomic<int> _readers[2];
+
+    /* Snapshots replaced during the current epoch, and ones replaced during the previous epoch that only
+     * readers counted in it could still be copying. Only update() touches these */
+    std::vector<const std::shared_ptr<const Snapshot> *> _waiting;
+    std::vector<const std::shared_ptr<const Snapshot> *> _draining;
+};
+
+#endif // STYLECACHE_H
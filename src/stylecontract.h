@@ -0,0 +1,77 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef STYLECONTRACT_H
+#define STYLECONTRACT_H
+#include <array>
+#include <string>
+#include <memory> // std::shared_ptr
+#include <stdexcept> // std::runtime_error
+
+#include "stylebundle.h"
+#include "probcfg.h"
+#include "lengthbounds.h"
+
+namespace comper {
+    /// How many steps a style is checked for when we don't know how long the song is. 16 bars of 4/4
+    const int defaultContractSteps = 16 * 4 + 1;
+
+    /**
+     * Throw an error if some derivation of the CFG [`name`] can be shorter than `perStep` * (`steps` - 1)
+     * units after `steps` steps for any `steps` from 1 to `maxSteps`, going by `bounds`. `unit` names the
+     * units in the error message
+     */
+    void checkMinimumLength(const std::string name, const LengthBounds &bounds, const int maxSteps,
+            const int perStep, const std::string unit) {
+        for(int steps = 1; steps <= maxSteps; ++steps) {
+            if(bounds.minimum(steps) < (long long)perStep * (steps - 1)) {
+                throw std::runtime_error("The CFG [" + name + "] can generate only " +
+                                         std::to_string(bounds.minimum(steps)) + " " + unit + " in " +
+                                         std::to_string(steps) + " steps but needs at least " +
+                                         std::to_string(perStep * (steps - 1)));
+            }
+        }
+    }
+
+    /**
+     * Check that `style` has every CFG style.md asks for and that none of them can run out before
+     * genSimpleWalkingBassline or genComping are done reading them, for songs of up to `maxSteps` - 1
+     * quarter notes. Both read at most n - 1 characters(or n - 1 quarter notes of rhythm) from output
+     * generated in n steps, so that is what every CFG must provide. Throws an error otherwise
+     */
+    void checkStyleContract(const StyleBundle &style, const int maxSteps) {
+        // The bounds worked out when the CFGs were compiled are used unless the song is longer
+        for(const std::string name : {"bassPattern", "bassDirection", "compingDirection"}) {
+            const ProbCFG &cfg = style[name];
+            std::shared_ptr<const LengthBounds> bounds = cfg.lengthBounds();
+            if(maxSteps > bounds->maxSteps()) {
+                bounds = std::make_shared<const LengthBounds>(*cfg.compiled(), maxSteps);
+            }
+            checkMinimumLength(name, *bounds, maxSteps, 1, "characters");
+        }
+        // Measure the rhythm in eighth notes. Anything else generates nothing
+        std::array<int, 256> eighthNotes;
+        eighthNotes.fill(0);
+        eighthNotes['e'] = eighthNotes['8'] = 1;
+        eighthNotes['q'] = eighthNotes['4'] = 2;
+        eighthNotes['2'] = 4;
+        eighthNotes['1'] = 8;
+        LengthBounds rhythm(*style["compingRhythm"].compiled(), maxSteps, eighthNotes);
+        checkMinimumLength("compingRhythm", rhythm, maxSteps, 2, "eighth notes");
+    }
+}
+#endif // STYLECONTRACT_H
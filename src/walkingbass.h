@@ -0,0 +1,264 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef WALKINGBASS_H
+#define WALKINGBASS_H
+#include <vector>
+#include <string>
+#include <stdexcept> // std::runtime_error
+#include <cstdint>
+#include <cstring> // memset
+
+#include "chord.h"
+#include "chordsymbol.h"
+#include "chordvalue.h"
+#include "note.h"
+#include "notevalue.h"
+#include "probcfg.h"
+#include "cfgstream.h"
+#include "note_numbers.h"
+#include "bassutils.h"
+#include "random.h"
+#include "simpleBassline.h" // comper::quarterNoteChord
+
+namespace comper {
+    /// What a bass pattern character tells the walking bass state machine to do
+    enum BassAction : int8_t {
+        // Actions 0-7 move to the closest note of that chord tone(see Chord::notes)
+        ChordToneStep = 8, // 'A' and 'C'
+        SecondChordToneStep, // 'F'
+        ScaleStep, // 'S'
+        OctaveStep, // 'O'
+        RepeatStep, // 'R'
+        BASS_ACTION_COUNT,
+        // Anything below 0 is an error
+        EndOfPattern = -1,
+        IllegalDigit = -2,
+        IllegalCharacter = -3
+    };
+
+    // Maps each character of a bass pattern to its BassAction
+    struct BassActions {
+        int8_t actions[256];
+    };
+
+    constexpr BassActions makeBassActions() {
+        BassActions ret = {};
+        for(int c = 0; c < 256; ++c) {
+            ret.actions[c] = IllegalCharacter;
+        }
+        for(int digit = 0; digit < 10; ++digit) {
+            ret.actions['0' + digit] = (int8_t)(digit < ChordToneStep ? digit : IllegalDigit);
+        }
+        ret.actions[0] = EndOfPattern;
+        ret.actions['A'] = ret.actions['C'] = ChordToneStep;
+        ret.actions['F'] = SecondChordToneStep;
+        ret.actions['S'] = ScaleStep;
+        ret.actions['O'] = OctaveStep;
+        ret.actions['R'] = RepeatStep;
+        return ret;
+    }
+
+    constexpr BassActions BASS_ACTIONS = makeBassActions();
+
+    /**
+     * How far each BassAction moves a note of every pitch class in either direction and how far each leading
+     * note is from the note before it. Both only depend on the chord symbol, so they are tabled once per
+     * symbol and every note is a lookup rather than a search through the chord. Symbols are hashed by
+     * address into a few slots and go in the next free one of the slots after it if they collide. Once
+     * those are all taken the last of them is built again for the new symbol
+     */
+    class BassSteps {
+    public:
+        BassSteps() : _slots(1 << _slotBits, Tables{nullptr, {}, {}}), _tables(nullptr) {}
+
+        /// Look everything up in `chord`'s tables from now on, building them if they aren't already
+        void select(const quarterNoteChord &chord) {
+            const ChordSymbol &symbol = chord.symbol();
+            const size_t home = (uint64_t)(uintptr_t)&symbol * 0x9e3779b97f4a7c15 >> (64 - _slotBits);
+            _chord = chord.value();
+            for(size_t probe = 0; probe < _probes; ++probe) {
+                _tables = &_slots[(home + probe) % _slots.size()];
+                if(_tables->symbol == &symbol) {
+                    return;
+                } else if(_tables->symbol == nullptr) {
+                    break;
+                }
+            }
+            _build(symbol);
+        }
+
+        /// Return how far `action` moves a note with pitch class `pitchClass` up(`up`) or down
+        int step(const int action, const bool up, const int pitchClass) const {
+            return _tables->steps[action][up][pitchClass];
+        }
+
+        /**
+         * Return how far closestLeadingNote moves a note with pitch class `pitchClass` to lead to a bass note
+         * with pitch class `nextBass`
+         */
+        int leadingStep(const bool up, const int pitchClass, const int nextBass) {
+            int8_t &step = _tables->leading[up][pitchClass][nextBass];
+            if(step == _unknown) {
+                NoteValue from(MIDDLE_C + pitchClass);
+                step = (int8_t)(closestLeadingNote(from, NoteValue(nextBass), _chord, (Direction)up).number() -
+                        from.number());
+            }
+            return step;
+        }
+
+        /// Return the pitch class of midi number `number`, whatever its sign
+        static int pitchClass(const int number) {
+            return (number % NUM_NOTES + NUM_NOTES) % NUM_NOTES;
+        }
+
+    private:
+        /* steps[action][up][pitch class] is how far `action` moves a note with that pitch class.
+         * leading[up][pitch class][next bass pitch class] is how far the leading note is from it, or
+         * _unknown until it is first needed */
+        struct Tables {
+            const ChordSymbol *symbol;
+            int8_t steps[BASS_ACTION_COUNT][2][NUM_NOTES];
+            int8_t leading[2][NUM_NOTES][NUM_NOTES];
+        };
+
+        // Fill in the selected slot for `symbol`, whose chord is _chord
+        void _build(const ChordSymbol &symbol) {
+            _tables->symbol = &symbol;
+            memset(_tables->leading, _unknown, sizeof(_tables->leading));
+            const int root = _chord.root().pitchClass();
+            for(int up = 0; up < 2; ++up) {
+                for(int pitchClass = 0; pitchClass < NUM_NOTES; ++pitchClass) {
+                    // The closest note of a chord tone's pitch class, in our direction unless it is close
+                    for(int tone = 0; tone < ChordToneStep; ++tone) {
+                        int step = CLOSEST_STEPS.steps[pitchClass][_chord.note(tone).pitchClass()];
+                        if(step > 2 && !up) {
+                            step -= NUM_NOTES;
+                        } else if(step < -2 && up) {
+                            step += NUM_NOTES;
+                        }
+                        _tables->steps[tone][up][pitchClass] = (int8_t)step;
+                    }
+                    // The neighbour tables count up from the root
+                    auto neighbour = [root, up](const PitchNeighbours &neighbours, const int pitchClass) {
+                        int relative = (pitchClass - root + NUM_NOTES) % NUM_NOTES;
+                        return up ? neighbours.up[relative] : -neighbours.down[relative];
+                    };
+                    int chordStep = neighbour(symbol.chordTones, pitchClass);
+                    _tables->steps[ChordToneStep][up][pitchClass] = (int8_t)chordStep;
+                    _tables->steps[SecondChordToneStep][up][pitchClass] = (int8_t)(chordStep +
+                            neighbour(symbol.chordTones, (pitchClass + chordStep + NUM_NOTES) % NUM_NOTES));
+                    _tables->steps[ScaleStep][up][pitchClass] = (int8_t)neighbour(symbol.scaleTones, pitchClass);
+                    _tables->steps[OctaveStep][up][pitchClass] = (int8_t)(up ? NUM_NOTES : -NUM_NOTES);
+                    _tables->steps[RepeatStep][up][pitchClass] = 0;
+                }
+            }
+        }
+
+        static const int8_t _unknown = INT8_MAX;
+        static const int _slotBits = 6;
+        static const size_t _probes = 8;
+
+        std::vector<Tables> _slots;
+
+        // The selected chord's slot and the chord itself
+        Tables *_tables;
+        ChordValue _chord;
+    };
+
+    /**
+     * Generates the same bassline as genSimpleWalkingBassline for the same state of `random`, but as a
+     * state machine over midi numbers that returns one NoteValue per note. See genSimpleWalkingBassline
+     * for what the parameters and the characters of each pattern mean, except that only the digits 0-7
+     * name chord tones.
+     *
+     * The only state kept from note to note is the previous midi number and the directions forced by
+     * going out of range. Each note is a lookup in the chord's BassSteps. Nothing is named, so notes are
+     * only spelled if they are turned into Notes afterwards. The streams and tables are kept per thread
+     * and reused from call to call, so once they have grown big enough only the bassline is allocated
+     */
+    std::vector<NoteValue> genWalkingBassline(const std::vector<quarterNoteChord> &progression,
+            const ProbCFG &patternCFG, const ProbCFG &directionCFG, const Note lowestNote,
+            const Note highestNote, Random &random, int velocity = 100) {
+        if(lowestNote > highestNote) {
+            throw std::runtime_error("LowestNote should be below highestNote");
+        }
+        std::vector<NoteValue> bassline;
+        int totalDuration = 0;
+        for(const quarterNoteChord &chord : progression) {
+            totalDuration += chord.duration();
+        }
+        bassline.reserve(totalDuration + 1);
+        const int lowest = lowestNote.number(), highest = highestNote.number();
+        const int startOctave = (lowestNote.octave() + highestNote.octave()) / 2;
+        // The tables are keyed by interned chord symbols, which never go away, so they stay right between calls
+        thread_local CFGStream pattern, directions;
+        // Directions forced by going out of range, stored in reverse so the next one is at the back
+        thread_local std::string forcedDirections;
+        thread_local BassSteps steps;
+        int prev = 0;
+        for(size_t chord = 0; chord < progression.size(); ++chord) {
+            steps.select(progression[chord]);
+            const int duration = progression[chord].duration();
+            patternCFG.stream(duration, random, pattern);
+            directionCFG.stream(duration, random, directions);
+            forcedDirections.clear();
+            for(int i = 0; i < duration - 1; ++i) {
+                int action = BASS_ACTIONS.actions[(unsigned char)pattern.next()];
+                if(action == EndOfPattern) {
+                    throw std::runtime_error("One of the provided CFGs produced output that was too short");
+                }
+                // Begin with the first root in the progression between the limit notes
+                if(bassline.empty()) {
+                    directions.next();
+                    prev = progression[chord].value().bass().withOctave(startOctave).number();
+                    bassline.push_back(NoteValue(prev, 4, velocity));
+                    continue;
+                } else if(action < 0) {
+                    throw std::runtime_error(action == IllegalDigit ? "can only have the digits 0-7" :
+                            "Illegal character in CFG");
+                }
+                // If we go too high or too low, turn around
+                if(prev > highest) {
+                    forcedDirections += "DDDD";
+                } else if(prev < lowest) {
+                    forcedDirections += "UUUU";
+                }
+                char direction;
+                if(forcedDirections.empty()) {
+                    direction = directions.next();
+                    if(direction == '\0') {
+                        throw std::runtime_error("One of the provided CFGs produced output that was too short");
+                    }
+                } else {
+                    direction = forcedDirections.back();
+                    forcedDirections.pop_back();
+                }
+                prev += steps.step(action, direction == 'U', BassSteps::pitchClass(prev));
+                bassline.push_back(NoteValue(prev, 4, velocity));
+            }
+            // Lead to the next chord's bass
+            const bool up = (forcedDirections.empty() ? directions.next() : forcedDirections.back()) == 'U';
+            const int nextBass = progression[(chord + 1) % progression.size()].value().bass().pitchClass();
+            prev += steps.leadingStep(up, BassSteps::pitchClass(prev), nextBass);
+            bassline.push_back(NoteValue(prev, 4, velocity));
+        }
+        bassline.push_back(bassline[0].withDuration(1));
+        return bassline;
+    }
+} // comper
+#endif
@@ -19,8 +19,47 @@ along with Comper.  If not, see <https://www.gnu.org/licenses/>.
 #define WEIGHTED_VECTOR_H
 #include <vector>
 #include <stdexcept> // runtime_error
+#include <algorithm> // std::find_if
+#include <numeric> // std::accumulate
 
-#include <QRandomGenerator64>
+#include "random.h"
+
+/**
+ * Builds a Walker/Vose alias table for the `count` weights starting at `weights` that sum to
+ * `totalWeight`. Column i is picked with probability 1/count and then a number in
+ * [0, totalWeight) below `thresholds[i]` selects i while anything else selects `aliases[i]`.
+ * Everything is kept in integers so the resulting distribution is exactly that of the weights
+ * @cite https://www.keithschwarz.com/darts-dice-coins/
+ */
+inline void buildAliasTable(const int *weights, const int count, const int totalWeight,
+        long long *thresholds, int *aliases) {
+    // Scale every weight by count so that a full column has a threshold of exactly totalWeight
+    std::vector<int> small, large;
+    for(int i = 0; i < count; ++i) {
+        thresholds[i] = (long long)weights[i] * count;
+        aliases[i] = i;
+        (thresholds[i] < totalWeight ? small : large).push_back(i);
+    }
+    // Fill up each underfull column with the excess of an overfull one
+    while(!small.empty() && !large.empty()) {
+        int underfull = small.back();
+        int overfull = large.back();
+        small.pop_back();
+        aliases[underfull] = overfull;
+        thresholds[overfull] -= totalWeight - thresholds[underfull];
+        if(thresholds[overfull] < totalWeight) {
+            large.pop_back();
+            small.push_back(overfull);
+        }
+    }
+    // Whatever is left is full up to rounding so it always selects itself
+    for(int i : large) {
+        thresholds[i] = totalWeight;
+    }
+    for(int i : small) {
+        thresholds[i] = totalWeight;
+    }
+}
 
 /**
  * Class that, given a weight vector and a vector of elements with each element in the weight
@@ -60,6 +99,8 @@ public:
         _elements.push_back(element);
         _weights.push_back(weight);
         _totalWeight += weight;
+        _thresholds.clear();
+        _aliases.clear();
     }
 
     /// Appends `elements` and `weights` to our vector
@@ -73,17 +114,37 @@ public:
         _elements.insert(_elements.end(), elements.begin(), elements.end());
         _weights.insert(_weights.end(), weights.begin(), weights.end());
         _totalWeight = std::accumulate(_weights.begin(), _weights.end(), 0);
+        freeze();
     }
 
     /**
-     * Returns an element from our vector by using a weighted random selection
+     * Build the alias table so getElement takes constant time. Done automatically after inserting a
+     * vector of elements. Inserting a single element goes back to a linear search until we freeze again
+     */
+    void freeze() {
+        _thresholds.resize(size());
+        _aliases.resize(size());
+        buildAliasTable(_weights.data(), (int)size(), _totalWeight, _thresholds.data(), _aliases.data());
+    }
+
+    /// Return true if getElement uses the alias table rather than a linear search
+    bool frozen() const {
+        return !_aliases.empty();
+    }
+
+    /**
+     * Returns an element from our vector by using a weighted random selection drawn from `random`
      * @cite https://stackoverflow.com/questions/1761626/weighted-random-numbers
      */
-    elementType getElement() const {
+    elementType getElement(Random &random) const {
         if(size() == 0) {
             throw std::runtime_error("Cannot get element of empty vector");
+        } else if(frozen()) {
+            int column = random.bounded((int)size());
+            return random.bounded(_totalWeight) < _thresholds[column] ?
+                        _elements[column] : _elements[_aliases[column]];
         }
-        int choice = QRandomGenerator64::global()->bounded(_totalWeight);
+        int choice = random.bounded(_totalWeight);
         for(size_t i = 0; i < _elements.size(); i++) {
             if(choice < _weights[i]) {
                 return _elements[i];
@@ -116,5 +177,9 @@ private:
     std::vector<elementType> _elements;
     std::vector<int> _weights;
     int _totalWeight;
+
+    // The alias table built by freeze(). Both are empty when we aren't frozen
+    std::vector<long long> _thresholds;
+    std::vector<int> _aliases;
 };
 #endif // WEIGHTED_VECTOR_H
@@ -0,0 +1,177 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <new> // std::bad_alloc
+#include <cstdlib> // std::malloc, std::free
+#include <string>
+#include <vector>
+#include <functional> // std::function
+
+#include "simpleBassline.h"
+#include "walkingbass.h"
+#include "optimalbass.h"
+#include "comp.h"
+#include "drum.h"
+#include "stylebundle.h"
+#include "note.h"
+#include "notevalue.h"
+#include "midiwriter.h"
+#include "midifile/MidiFile.h"
+#include "random.h"
+#include "../check.h"
+#include "../samples.h"
+
+// Every operator new made while `counting` is set is counted in `allocations`
+static long long allocations = 0;
+static bool counting = false;
+
+/* Arrays and the nothrow forms all go through these in libstdc++ and libc++, so replacing them
+ * counts every allocation the generators make */
+void *operator new(std::size_t size) {
+    allocations += counting;
+    if(void *memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+// Return how many allocations generating with `generate` takes. The output is freed afterwards
+template <typename Generate>
+long long countAllocations(Generate generate) {
+    allocations = 0;
+    counting = true;
+    [[maybe_unused]] auto output = generate();
+    counting = false;
+    return allocations;
+}
+
+int main() {
+    StyleBundle style;
+    style.fromFile(SAMPLE_STYLE);
+    const ProbCFG &bassPattern = style["bassPattern"], &bassDirection = style["bassDirection"];
+    const ProbCFG &compingRhythm = style["compingRhythm"], &compingDirection = style["compingDirection"];
+    const std::vector<std::vector<int>> voicings = {{3, 6, 7, 9}, {7, 9, 3, 5}};
+    const Note lowest("C", 3), highest("G", 3), reference("G", 5);
+    // Each generator returns one vector, so that is all it may allocate once it has been run
+    const std::vector<std::pair<std::string, std::function<long long(const std::vector<Chord> &, Random &)>>>
+            generators = {
+        {"genSimpleWalkingBassline", [&](const std::vector<Chord> &progression, Random &random) {
+            return countAllocations([&]() {
+                return comper::genSimpleWalkingBassline(progression, bassPattern, bassDirection, lowest, highest,
+                                                        random);
+            });
+        }},
+        {"genWalkingBassline", [&](const std::vector<Chord> &progression, Random &random) {
+            return countAllocations([&]() {
+                return comper::genWalkingBassline(progression, bassPattern, bassDirection, lowest, highest, random);
+            });
+        }},
+        {"genOptimalWalkingBassline", [&](const std::vector<Chord> &progression, Random &random) {
+            return countAllocations([&]() {
+                return comper::genOptimalWalkingBassline(progression, bassPattern, bassDirection, lowest, highest,
+                                                         random);
+            });
+        }},
+        {"genComping", [&](const std::vector<Chord> &progression, Random &random) {
+            return countAllocations([&]() {
+                return comper::genComping(progression, compingRhythm, compingDirection, voicings, reference,
+                                          random);
+            });
+        }},
+        {"genComping with optimal voicing", [&](const std::vector<Chord> &progression, Random &random) {
+            return countAllocations([&]() {
+                return comper::genComping(progression, compingRhythm, compingDirection, voicings, reference,
+                                          random, 100, true);
+            });
+        }},
+        {"addSimpleDrumSwingPattern", [&](const std::vector<Chord> &progression, Random &) {
+            return countAllocations([&]() {
+                return comper::addSimpleDrumSwingPattern((int)progression.size());
+            });
+        }}
+    };
+    std::vector<std::vector<Chord>> songs;
+    for(int repetitions : {50, 1, 10}) {
+        for(const std::string &fileName : SAMPLE_PROGRESSIONS) {
+            songs.push_back(comper::readProgression(fileName, repetitions));
+        }
+    }
+    /* Writing a track may only allocate what the midi events themselves need, so it must allocate exactly what a
+     * bare smf::MidiFile given the same events does, whether the notes are Notes or NoteValues */
+    for(size_t song = 0; song < songs.size(); ++song) {
+        Random random(1);
+        const std::vector<NoteValue> values = comper::genWalkingBassline(songs[song], bassPattern, bassDirection,
+                                                                         lowest, highest, random);
+        const std::vector<NoteValue> drums = comper::addSimpleDrumSwingPattern((int)songs[song].size());
+        std::vector<Note> notes;
+        for(const NoteValue &value : values) {
+            notes.push_back(Note(value.number(), value.duration(), value.velocity()));
+        }
+        auto bare = [&]() {
+            smf::MidiFile file;
+            file.setTicksPerQuarterNote(120);
+            for(int track = 0; track < 2; ++track) {
+                const std::vector<NoteValue> &line = track == 0 ? values : drums;
+                file.addTrack();
+                file.addPatchChange(track, 0, track, 34);
+                file.addTempo(track, 0, 120);
+                int tick = 0;
+                for(const NoteValue &note : line) {
+                    file.addNoteOn(track, tick, track, note.number(), note.velocity());
+                    tick += 480 / note.duration();
+                    file.addNoteOff(track, tick, track, note.number(), note.velocity());
+                }
+            }
+            return 0;
+        };
+        auto written = [&](const auto &bassline) {
+            return [&]() {
+                MidiWriter writer(120, 2.0 / 3.0);
+                writer.addNotes(bassline, 34);
+                writer.addNotes(drums, 0, true);
+                return 0;
+            };
+        };
+        const long long expected = countAllocations(bare);
+        const long long valueCount = countAllocations(written(values)), noteCount = countAllocations(written(notes));
+        check(valueCount == expected, "MidiWriter allocated " + std::to_string(valueCount) + " times for the "
+              "NoteValues of song " + std::to_string(song) + " instead of " + std::to_string(expected));
+        check(noteCount == expected, "MidiWriter allocated " + std::to_string(noteCount) + " times for the Notes of "
+              "song " + std::to_string(song) + " instead of " + std::to_string(expected));
+    }
+    for(const auto &generator : generators) {
+        // Generate every song once so the scratch buffers grow as big as they will need to be
+        Random random(1);
+        for(const std::vector<Chord> &song : songs) {
+            generator.second(song, random);
+        }
+        for(size_t song = 0; song < songs.size(); ++song) {
+            long long count = generator.second(songs[song], random);
+            check(count == 1, generator.first + " allocated " + std::to_string(count) + " times for song " +
+                  std::to_string(song) + " instead of only allocating its output");
+        }
+    }
+    return result();
+}
@@ -0,0 +1,15 @@
+# Checks that generating again only allocates the output and that writing it only allocates midi events, by
+# counting every operator new
+include(../../comper.pri)
+
+TARGET = allocations
+CONFIG += console testcase
+CONFIG -= app_bundle
+DEFINES += SAMPLES_DIR=\\\"$$PWD/../..\\\"
+
+HEADERS += \
+     ../check.h \
+     ../samples.h
+
+SOURCES += \
+     allocations.cpp
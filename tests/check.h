@@ -0,0 +1,46 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef CHECK_H
+#define CHECK_H
+#include <iostream>
+#include <string>
+
+/* The test programs share these. Every failed check is reported and counted, and main returns
+ * whether anything failed so that `make check` stops */
+
+/// The number of checks that have failed so far
+inline int failures = 0;
+
+/// Count a failure and report `what` if `passed` is false. Returns `passed`
+inline bool check(const bool passed, const std::string &what) {
+    if(!passed) {
+        ++failures;
+        std::cerr << "FAILED: " << what << std::endl;
+    }
+    return passed;
+}
+
+/// The exit status of a test program that has made its checks
+inline int result() {
+    if(failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+    }
+    return failures > 0;
+}
+
+#endif // CHECK_H
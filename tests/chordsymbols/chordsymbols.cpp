@@ -0,0 +1,162 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <array>
+#include <vector>
+#include <stdexcept> // std::runtime_error
+
+#include "chordsymbol.h"
+#include "../check.h"
+
+/* Chord names and what they parsed into before the lexer was made single pass. These cover every kind of
+ * token, accidentals after the root and bass that do and don't start an alteration, the chords in the
+ * sample progressions, and the errors that point at the furthest position any reading got to */
+struct Parsed {
+    std::string name, bass, first;
+    int bassSpelling, firstSpelling;
+    std::array<int, 6> degrees;
+};
+
+struct Invalid {
+    // The error is the name followed by `message`
+    std::string name, message;
+};
+
+int main() {
+    const std::vector<Parsed> parsed = {
+        {"C",        "C", "C", 0, 0, {2, 4, 5, 7, 9, 11}},
+        {"Cb",       "Cb", "Cb", 11, 11, {2, 4, 5, 7, 9, 11}},
+        {"C#",       "C#", "C#", 1, 1, {2, 4, 5, 7, 9, 11}},
+        {"c",        "c", "c", 0, 0, {2, 3, 5, 7, 9, 10}},
+        {"D-",       "D", "D-", 2, 2, {2, 3, 5, 7, 9, 10}},
+        {"G7",       "G", "G7", 7, 7, {2, 4, 5, 7, 9, 10}},
+        {"Cmaj",     "C", "Cm", 0, 0, {2, 4, 5, 7, 9, 11}},
+        {"Cmaj7",    "C", "Cm", 0, 0, {2, 4, 5, 7, 9, 11}},
+        {"Cmin",     "C", "Cm", 0, 0, {2, 3, 5, 7, 9, 10}},
+        {"Cm",       "C", "Cm", 0, 0, {2, 3, 5, 7, 9, 10}},
+        {"Cm7",      "C", "Cm", 0, 0, {2, 3, 5, 7, 9, 10}},
+        {"Cmb5",     "C", "Cm", 0, 0, {2, 3, 5, 6, 9, 10}},
+        {"C7b9",     "C", "C7", 0, 0, {1, 4, 5, 7, 9, 10}},
+        {"C7#9",     "C", "C7", 0, 0, {3, 4, 5, 7, 9, 10}},
+        {"C7#11",    "C", "C7", 0, 0, {2, 4, 6, 7, 9, 10}},
+        {"C7b13",    "C", "C7", 0, 0, {2, 4, 5, 7, 8, 10}},
+        {"Bbm7",     "Bb", "Bb", 10, 10, {2, 3, 5, 7, 9, 10}},
+        {"Bb/D",     "D", "Bb", 2, 10, {2, 4, 5, 7, 9, 11}},
+        {"C/E",      "E", "C/", 4, 0, {2, 4, 5, 7, 9, 11}},
+        {"C/Eb",     "Eb", "C/", 3, 0, {2, 4, 5, 7, 9, 11}},
+        {"C/F#",     "F#", "C/", 6, 0, {2, 4, 5, 7, 9, 11}},
+        {"C/C#b",    "C#", "C/", 1, 0, {2, 4, 5, 7, 9, 11}},
+        {"C/Bb7",    "Bb", "C/", 10, 0, {2, 4, 5, 7, 9, 10}},
+        {"C/Db9",    "Db", "C/", 1, 0, {1, 4, 5, 7, 9, 10}},
+        {"Ab/Eb7",   "Eb", "Ab", 3, 8, {2, 4, 5, 7, 9, 10}},
+        {"F#/C#b9",  "C#", "F#", 1, 6, {1, 4, 5, 7, 9, 10}},
+        {"Cdim",     "C", "Cd", 0, 0, {2, 3, 5, 6, 9, 9}},
+        {"C dim",    "C", "C ", 0, 0, {2, 3, 5, 6, 9, 9}},
+        {"C#dim",    "C#", "C#", 1, 1, {2, 3, 5, 6, 9, 9}},
+        {"Cdim7",    "C", "Cd", 0, 0, {2, 3, 5, 6, 9, 9}},
+        {"Chdim",    "C", "Ch", 0, 0, {2, 3, 5, 6, 9, 10}},
+        {"Caug",     "C", "Ca", 0, 0, {2, 4, 5, 8, 9, 10}},
+        {"C+",       "C", "C+", 0, 0, {2, 4, 5, 8, 9, 10}},
+        {"C-7",      "C", "C-", 0, 0, {2, 3, 5, 7, 9, 10}},
+        {"C~",       "C", "C~", 0, 0, {2, 3, 5, 7, 9, 10}},
+        {"C m",      "C", "C ", 0, 0, {2, 3, 5, 7, 9, 10}},
+        {"C m7",     "C", "C ", 0, 0, {2, 3, 5, 7, 9, 10}},
+        {"Cmaug",    "C", "Cm", 0, 0, {2, 3, 5, 8, 9, 10}},
+        {"Cm+",      "C", "Cm", 0, 0, {2, 3, 5, 8, 9, 10}},
+        {"Cm#11",    "C", "Cm", 0, 0, {2, 3, 6, 7, 9, 10}},
+        {"C 7",      "C", "C ", 0, 0, {2, 4, 5, 7, 9, 10}},
+        {"e",        "e", "e", 4, 4, {2, 3, 5, 7, 9, 10}},
+        {"eb",       "eb", "eb", 3, 3, {2, 3, 5, 7, 9, 10}},
+        {"f#dim",    "f#", "f#", 6, 6, {2, 3, 5, 6, 9, 9}},
+        {"Cmm",      "C", "Cm", 0, 0, {2, 3, 5, 7, 9, 10}},
+        {"Cmaj7#11", "C", "Cm", 0, 0, {2, 4, 6, 7, 9, 11}},
+        {"Gb13",     "Gb", "Gb", 6, 6, {2, 4, 5, 7, 8, 10}},
+        {"Bbb9",     "Bb", "Bb", 10, 10, {1, 4, 5, 7, 9, 10}},
+        {"Ebmin7b5", "Eb", "Eb", 3, 3, {2, 3, 5, 6, 9, 10}},
+        {"Cb9#11",   "Cb", "Cb", 11, 11, {1, 4, 6, 7, 9, 10}},
+        {"Db7#9",    "Db", "Db", 1, 1, {3, 4, 5, 7, 9, 10}},
+        {"Bb7b9",    "Bb", "Bb", 10, 10, {1, 4, 5, 7, 9, 10}},
+        {"C#7#9",    "C#", "C#", 1, 1, {3, 4, 5, 7, 9, 10}},
+        {"C/Ebb9",   "Eb", "C/", 3, 0, {1, 4, 5, 7, 9, 10}},
+        {"C/Eb7b9",  "Eb", "C/", 3, 0, {1, 4, 5, 7, 9, 10}},
+        {"C/E#b9",   "E#", "C/", 5, 0, {1, 4, 5, 7, 9, 10}},
+        {"C#11",     "C#", "C#", 1, 1, {2, 4, 6, 7, 9, 10}},
+        {"C/F##9",   "F#", "C/", 6, 0, {3, 4, 5, 7, 9, 10}},
+        {"Bb 7",     "Bb", "Bb", 10, 10, {2, 4, 5, 7, 9, 10}},
+        {"D b9",     "D", "D ", 2, 2, {1, 4, 5, 7, 9, 10}},
+        {"D7 b9",    "D", "D7", 2, 2, {1, 4, 5, 7, 9, 10}},
+        {"F#-",      "F#", "F#", 6, 6, {2, 3, 5, 7, 9, 10}},
+        {"B-7",      "B", "B-", 11, 11, {2, 3, 5, 7, 9, 10}},
+    };
+    const std::vector<Invalid> invalid = {
+        {"",        " is an invalid chord name: it must start with a note name"},
+        {"Db7",     " contains unclear placement of initial accidental at position 1"},
+        {"Db9",     " contains unclear placement of initial accidental at position 1"},
+        {"Cb9",     " contains unclear placement of initial accidental at position 1"},
+        {"C#9",     " contains unclear placement of initial accidental at position 1"},
+        {"Cb7",     " contains unclear placement of initial accidental at position 1"},
+        {"C#7",     " contains unclear placement of initial accidental at position 1"},
+        {"Bb7",     " contains unclear placement of initial accidental at position 1"},
+        {"Bbmaj/D", " is an invalid chord name: unexpected '/' at position 5"},
+        {"C13",     " is an invalid chord name: unexpected '1' at position 1"},
+        {"C11",     " is an invalid chord name: unexpected '1' at position 1"},
+        {"eb7",     " contains unclear placement of initial accidental at position 1"},
+        {"Cb9x",    " is an invalid chord name: unexpected 'x' at position 3"},
+        {"C#9x",    " is an invalid chord name: unexpected 'x' at position 3"},
+        {"C/Eb9x",  " is an invalid chord name: unexpected 'x' at position 5"},
+        {"X",       " is an invalid chord name: it must start with a note name"},
+        {"1",       " is an invalid chord name: it must start with a note name"},
+        {"C9",      " is an invalid chord name: unexpected '9' at position 1"},
+        {"Cb1",     " contains unclear placement of initial accidental at position 1"},
+        {"Cx",      " is an invalid chord name: unexpected 'x' at position 1"},
+        {"C/",      " is an invalid chord name: it ends early at position 2"},
+        {"C/X",     " is an invalid chord name: unexpected 'X' at position 2"},
+        {"Cb/X",    " is an invalid chord name: unexpected 'X' at position 3"},
+        {"C/E9",    " is an invalid chord name: unexpected '9' at position 3"},
+        {"Cmaj9",   " is an invalid chord name: unexpected '9' at position 4"},
+        {"Csus",    " is an invalid chord name: unexpected 's' at position 1"},
+        {"C#7b",    " is an invalid chord name: unexpected 'b' at position 3"},
+        {"Cdi",     " is an invalid chord name: unexpected 'd' at position 1"},
+        {"Ch",      " is an invalid chord name: unexpected 'h' at position 1"},
+        {"Cau",     " is an invalid chord name: unexpected 'a' at position 1"},
+        {"C7#7",    " is an invalid chord name: unexpected '#' at position 2"},
+        {"C b",     " is an invalid chord name: unexpected 'b' at position 2"},
+        {"Cm/",     " is an invalid chord name: unexpected '/' at position 2"},
+    };
+
+    for(const Parsed &expected : parsed) {
+        try {
+            const ChordSymbol &symbol = ChordSymbol::intern(expected.name);
+            check(symbol.bass == expected.bass && symbol.first == expected.first &&
+                  symbol.bassSpelling == expected.bassSpelling && symbol.firstSpelling == expected.firstSpelling &&
+                  symbol.degrees == expected.degrees, expected.name + " parsed differently");
+        } catch(const std::runtime_error &error) {
+            check(false, expected.name + " was rejected: " + error.what());
+        }
+    }
+    for(const Invalid &expected : invalid) {
+        try {
+            ChordSymbol::intern(expected.name);
+            check(false, expected.name + " was accepted");
+        } catch(const std::runtime_error &error) {
+            check(error.what() == expected.name + expected.message,
+                  expected.name + " gave the error " + error.what());
+        }
+    }
+    return result();
+}
@@ -0,0 +1,12 @@
+# Checks that chord names parse into the same records and errors as they always have
+include(../../comper.pri)
+
+TARGET = chordsymbols
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+HEADERS += \
+     ../check.h
+
+SOURCES += \
+     chordsymbols.cpp
@@ -0,0 +1,130 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream> // std::stringstream
+#include <stdexcept> // std::runtime_error
+#include <cstdint>
+#include <cstdlib> // mkdtemp
+
+#include <unistd.h> // unlink, rmdir
+
+#include "compiledstyle.h"
+#include "stylebundle.h"
+#include "probcfg.h"
+#include "random.h"
+#include "../check.h"
+#include "../samples.h"
+
+// Every error a damaged .stylec file may give instead of loading
+const std::vector<std::string> CORRUPTION_ERRORS = {
+    "Compiled grammar is corrupt",
+    " is corrupt",
+    " is not a compiled style file",
+    " was compiled by an incompatible version of comper",
+    "Could not map "
+};
+
+// Return true if `error` is one of CORRUPTION_ERRORS
+bool isCorruptionError(const std::string &error) {
+    for(const std::string &expected : CORRUPTION_ERRORS) {
+        if(error.find(expected) != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Write `contents` to `fileName` in one go
+void writeFile(const std::string &fileName, const std::string &contents) {
+    std::ofstream file(fileName, std::ios::binary);
+    file << contents;
+}
+
+/* Load the damaged .stylec file `fileName` and generate from every section of it. Either it loads and
+ * generates or it gives one of CORRUPTION_ERRORS, anything else(a crash included) fails */
+void loadDamaged(const std::string &fileName, const std::string &what) {
+    try {
+        CompiledStyle compiled(fileName);
+        for(int i = 0; i < compiled.sectionCount(); ++i) {
+            compiled.sectionName(i);
+            ProbCFG cfg;
+            cfg.fromCompiled(compiled.section(i));
+            Random random(1);
+            for(int steps : {1, 2, 8, 65}) {
+                cfg.generateString(steps, random);
+            }
+        }
+    } catch(const std::runtime_error &error) {
+        check(isCorruptionError(error.what()), what + " gives the error \"" + error.what() + "\"");
+    }
+}
+
+/* sample.style must come back from a .stylec file generating exactly what it did before, and any truncated
+ * or bit flipped copy of that file must either load or be reported as corrupt */
+int main() {
+    char directoryName[] = "/tmp/comper-compiledstyle-XXXXXX";
+    if(!check(mkdtemp(directoryName) != nullptr, "could not make a directory to write to")) {
+        return result();
+    }
+    const std::string directory = directoryName;
+    const std::string compiledName = directory + "/sample.stylec", damagedName = directory + "/damaged.stylec";
+    StyleBundle style;
+    style.fromFile(SAMPLE_STYLE);
+    CompiledStyle::write(style, compiledName);
+    check(CompiledStyle::isCompiledStyle(compiledName), "a written style is recognized as compiled");
+
+    // The round trip
+    StyleBundle loaded;
+    loaded.fromFile(compiledName);
+    check(loaded.names() == style.names(), "the compiled style has the same sections");
+    for(const std::string &name : style.names()) {
+        if(!loaded.contains(name)) {
+            continue;
+        }
+        for(int steps : {1, 2, 4, 8, 16, 65}) {
+            for(uint64_t seed = 1; seed <= 10; ++seed) {
+                Random random(seed), loadedRandom(seed);
+                check(style[name].generateString(steps, random) == loaded[name].generateString(steps, loadedRandom),
+                      "[" + name + "] generates something else after compiling with " + std::to_string(steps) +
+                      " steps and seed " + std::to_string(seed));
+            }
+        }
+    }
+
+    std::stringstream compiledFile;
+    compiledFile << std::ifstream(compiledName, std::ios::binary).rdbuf();
+    const std::string contents = compiledFile.str();
+    for(size_t size = 0; size < contents.size(); ++size) {
+        writeFile(damagedName, contents.substr(0, size));
+        loadDamaged(damagedName, "truncating to " + std::to_string(size) + " bytes");
+    }
+    for(size_t byte = 0; byte < contents.size(); ++byte) {
+        for(int bit = 0; bit < 8; ++bit) {
+            std::string damaged = contents;
+            damaged[byte] ^= (char)(1 << bit);
+            writeFile(damagedName, damaged);
+            loadDamaged(damagedName, "flipping bit " + std::to_string(bit) + " of byte " + std::to_string(byte));
+        }
+    }
+    unlink(compiledName.c_str());
+    unlink(damagedName.c_str());
+    rmdir(directory.c_str());
+    return result();
+}
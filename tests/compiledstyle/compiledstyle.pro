@@ -0,0 +1,14 @@
+# Checks that a .stylec file generates what its style did and that damaged ones are rejected cleanly
+include(../../comper.pri)
+
+TARGET = compiledstyle
+CONFIG += console testcase
+CONFIG -= app_bundle
+DEFINES += SAMPLES_DIR=\\\"$$PWD/../..\\\"
+
+HEADERS += \
+     ../check.h \
+     ../samples.h
+
+SOURCES += \
+     compiledstyle.cpp
@@ -0,0 +1,196 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <vector>
+#include <climits> // INT_MAX
+#include <algorithm> // std::max, std::min
+#include <functional> // std::function
+#include <stdexcept> // std::runtime_error
+#include <cstdint>
+
+#include "optimalbass.h"
+#include "walkingbass.h" // comper::BassSteps
+#include "stylebundle.h"
+#include "cfgstream.h"
+#include "chord.h"
+#include "note.h"
+#include "notevalue.h"
+#include "random.h"
+#include "../check.h"
+#include "../samples.h"
+
+// What genOptimalWalkingBassline drew for a note after the first: a pattern action or a leading note
+struct Move {
+    size_t chord;
+    bool drawnUp;
+    int action; // Below 0 leads to nextBass
+    int nextBass;
+};
+
+// The cost model documented on genOptimalWalkingBassline
+const int DIRECTION_COST = 2, RANGE_COST = 3, FOLD_COST = 4, LEADING_COST = 2;
+const int UNREACHABLE = INT_MAX / 2;
+
+// Draw the moves of `progression` from `random` the same way genOptimalWalkingBassline does
+std::vector<Move> drawMoves(const std::vector<comper::quarterNoteChord> &progression, const ProbCFG &patternCFG,
+                            const ProbCFG &directionCFG, Random &random) {
+    std::vector<Move> moves;
+    CFGStream pattern, directions;
+    bool started = false;
+    for(size_t chord = 0; chord < progression.size(); ++chord) {
+        const int duration = progression[chord].duration();
+        patternCFG.stream(duration, random, pattern);
+        directionCFG.stream(duration, random, directions);
+        for(int i = 0; i < duration - 1; ++i) {
+            int action = comper::BASS_ACTIONS.actions[(unsigned char)pattern.next()];
+            bool drawnUp = directions.next() == 'U';
+            if(started) {
+                moves.push_back({chord, drawnUp, action, 0});
+            }
+            started = true;
+        }
+        moves.push_back({chord, directions.next() == 'U', -1,
+                         progression[(chord + 1) % progression.size()].value().bass().pitchClass()});
+    }
+    return moves;
+}
+
+// Where `move` takes midi number `from` going up(`up`) or down with the limits `lowest` and `highest`
+struct Landing {
+    int number;
+    int cost;
+};
+
+Landing land(comper::BassSteps &steps, const std::vector<comper::quarterNoteChord> &progression, const Move &move,
+             const int from, const bool up, const int lowest, const int highest) {
+    steps.select(progression[move.chord]);
+    const int pitchClass = comper::BassSteps::pitchClass(from);
+    Landing ret = {from + (move.action >= 0 ? steps.step(move.action, up, pitchClass) :
+                                              steps.leadingStep(up, pitchClass, move.nextBass)),
+                   (up != move.drawnUp) * DIRECTION_COST};
+    for(; ret.number > highest + NUM_NOTES; ret.number -= NUM_NOTES) {
+        ret.cost += FOLD_COST;
+    }
+    for(; ret.number < lowest - NUM_NOTES; ret.number += NUM_NOTES) {
+        ret.cost += FOLD_COST;
+    }
+    ret.cost += RANGE_COST * std::max({0, ret.number - highest, lowest - ret.number});
+    if(move.action < 0) {
+        int distance = NoteValue(ret.number).shortestDistance(NoteValue(move.nextBass));
+        ret.cost += distance == 1 || distance == 2 || distance == 5 ? 0 : LEADING_COST;
+    }
+    return ret;
+}
+
+/* genOptimalWalkingBassline must follow the patterns and directions it draws, up to turning notes around, and
+ * the line it picks must cost no more than the greedy one that always goes the drawn way. For short songs it
+ * must cost exactly as little as the cheapest of every possible line */
+int main() {
+    StyleBundle style;
+    style.fromFile(SAMPLE_STYLE);
+    const ProbCFG &pattern = style["bassPattern"], &direction = style["bassDirection"];
+    const Note lowestNote("C", 3), highestNote("G", 3);
+    const int lowest = lowestNote.number(), highest = highestNote.number();
+    comper::BassSteps steps;
+    for(const std::string &fileName : SAMPLE_PROGRESSIONS) {
+        for(int repetitions : {1, 4}) {
+            const std::vector<comper::quarterNoteChord> progression = comper::readProgression(fileName, repetitions);
+            // Every line can be tried on the shortest song
+            const bool bruteForce = fileName == SAMPLE_PROGRESSIONS[0] && repetitions == 1;
+            for(uint64_t seed = 1; seed <= 20; ++seed) {
+                const std::string what = fileName + " repeated " + std::to_string(repetitions) +
+                        " times with seed " + std::to_string(seed);
+                Random random(seed), drawRandom(seed), againRandom(seed);
+                const std::vector<NoteValue> bassline = comper::genOptimalWalkingBassline(progression, pattern,
+                        direction, lowestNote, highestNote, random);
+                const std::vector<Move> moves = drawMoves(progression, pattern, direction, drawRandom);
+                check(random.generate64() == drawRandom.generate64(), "the draws aren't replayed for " + what);
+                check(bassline == comper::genOptimalWalkingBassline(progression, pattern, direction, lowestNote,
+                                                                     highestNote, againRandom),
+                      "the same seed gives another bassline for " + what);
+                if(!check(bassline.size() == moves.size() + 2, "the bassline has the wrong length for " + what)) {
+                    continue;
+                }
+                check(bassline.back() == bassline[0].withDuration(1), "the bassline doesn't end on its first note "
+                      "for " + what);
+                // Cost the line, making sure each note is somewhere its move could have gone
+                int cost = 0, greedyCost = 0, greedy = bassline[0].number();
+                bool inRange = true;
+                for(size_t i = 0; i < moves.size(); ++i) {
+                    const int from = bassline[i].number(), to = bassline[i + 1].number();
+                    inRange = inRange && to >= lowest - NUM_NOTES && to <= highest + NUM_NOTES;
+                    int moveCost = UNREACHABLE;
+                    for(bool up : {true, false}) {
+                        Landing landing = land(steps, progression, moves[i], from, up, lowest, highest);
+                        if(landing.number == to) {
+                            moveCost = std::min(moveCost, landing.cost);
+                        }
+                    }
+                    if(!check(moveCost != UNREACHABLE, "note " + std::to_string(i + 1) + " can't follow the one "
+                              "before it for " + what)) {
+                        break;
+                    }
+                    cost += moveCost;
+                    Landing landing = land(steps, progression, moves[i], greedy, moves[i].drawnUp, lowest, highest);
+                    greedy = landing.number;
+                    greedyCost += landing.cost;
+                }
+                check(inRange, "the bassline goes more than an octave past its limits for " + what);
+                check(cost <= greedyCost, "the bassline costs " + std::to_string(cost) + ", more than the greedy " +
+                      std::to_string(greedyCost) + " for " + what);
+                if(bruteForce) {
+                    int cheapest = UNREACHABLE;
+                    std::function<void(size_t, int, int)> tryEvery = [&](size_t i, int from, int soFar) {
+                        if(i == moves.size()) {
+                            cheapest = std::min(cheapest, soFar);
+                            return;
+                        }
+                        for(bool up : {true, false}) {
+                            Landing landing = land(steps, progression, moves[i], from, up, lowest, highest);
+                            tryEvery(i + 1, landing.number, soFar + landing.cost);
+                        }
+                    };
+                    tryEvery(0, bassline[0].number(), 0);
+                    check(cost == cheapest, "the bassline costs " + std::to_string(cost) + " but one costs " +
+                          std::to_string(cheapest) + " for " + what);
+                }
+            }
+        }
+    }
+
+    /* The first note is the first chord's bass, so there's nothing to lead from before the first chord ends.
+     * The sample directions come 4 at a time and give nothing in 1 step, so these give one per step */
+    std::vector<comper::quarterNoteChord> progression = comper::readProgression(SAMPLE_PROGRESSIONS[0], 1);
+    progression[0].setDuration(1);
+    ProbCFG everyStepPattern, everyStepDirection;
+    everyStepPattern.addRule("<START> = C<START> 1 | S<START> 1");
+    everyStepPattern.compile();
+    everyStepDirection.addRule("<START> = U<START> 1 | D<START> 1");
+    everyStepDirection.compile();
+    std::string error;
+    try {
+        Random random(1);
+        comper::genOptimalWalkingBassline(progression, everyStepPattern, everyStepDirection, lowestNote,
+                                          highestNote, random);
+    } catch(const std::runtime_error &e) {
+        error = e.what();
+    }
+    check(error == "The first chord must last at least 2 beats", "a 1 beat first chord gives the error \"" +
+          error + "\"");
+    return result();
+}
@@ -0,0 +1,14 @@
+# Checks that genOptimalWalkingBassline picks the cheapest line its draws allow
+include(../../comper.pri)
+
+TARGET = optimalbass
+CONFIG += console testcase
+CONFIG -= app_bundle
+DEFINES += SAMPLES_DIR=\\\"$$PWD/../..\\\"
+
+HEADERS += \
+     ../check.h \
+     ../samples.h
+
+SOURCES += \
+     optimalbass.cpp
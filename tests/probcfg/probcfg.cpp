@@ -0,0 +1,218 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <stdexcept> // std::runtime_error
+
+#include "probcfg.h"
+#include "compiledcfg.h"
+#include "cfgstream.h"
+#include "weighted_vector.h"
+#include "random.h"
+#include "../check.h"
+
+/* Rules and what rules() gives back after adding them, written as each nonterminal followed by its expansions
+ * with their symbols separated by spaces. These cover every part of the format described in probcfg.h */
+struct Parsed {
+    std::vector<std::string> rules;
+    std::string expected;
+};
+
+// A rule read from line `line`(0 for none) and the error it gives
+struct Invalid {
+    std::string rule;
+    int line;
+    std::string message;
+};
+
+// Rules that parse but can't be compiled and the error compiling them gives
+struct Incomplete {
+    std::vector<std::string> rules;
+    std::string message;
+};
+
+// Grammars and whether they are right linear(see CompiledCFG), which is when generate() walks them
+struct Shape {
+    std::vector<std::string> rules;
+    bool rightLinear;
+};
+
+// Write out `rules` the way Parsed::expected is written
+std::string describe(const std::map<std::string, weightedVector<std::vector<std::string>>> &rules) {
+    std::string ret;
+    for(const auto &rule : rules) {
+        ret += (ret.empty() ? "" : "; ") + rule.first + " =";
+        const std::vector<std::vector<std::string>> expansions = rule.second.elements();
+        const std::vector<int> weights = rule.second.weights();
+        for(size_t i = 0; i < expansions.size(); ++i) {
+            ret += i == 0 ? "" : " |";
+            for(const std::string &symbol : expansions[i]) {
+                ret += " " + (symbol.empty() ? "`" : symbol);
+            }
+            ret += " " + std::to_string(weights[i]);
+        }
+    }
+    return ret;
+}
+
+int main() {
+    const std::vector<Parsed> parsed = {
+        {{"<START> = aa<1> 10 | bb<2> 20"},   "<START> = aa <1> 10 | bb <2> 20"},
+        {{"<1>     = bcd 5"},                 "<1> = bcd 5"},
+        {{"  <A>=x 1"},                       "<A> = x 1"},
+        {{"<A> = ` 3"},                       "<A> = ` 3"},
+        {{"<A> = ` 3 | a<A> 2"},              "<A> = ` 3 | a <A> 2"},
+        {{"<A> = a 1 % a comment | b 2"},     "<A> = a 1"},
+        {{"<A> = a 007"},                     "<A> = a 7"},
+        {{"<A> = a 2147483647"},              "<A> = a 2147483647"},
+        {{"<A> = a-b+c_D9 4"},                "<A> = a-b+c_D9 4"},
+        {{"<A> = <B><C> 1"},                  "<A> = <B> <C> 1"},
+        {{"<A> = a<B>b 1"},                   "<A> = a <B> b 1"},
+        {{"<A> = a  5   |   b 6  "},          "<A> = a 5 | b 6"},
+        {{"<A_1-x+> = a 1"},                  "<A_1-x+> = a 1"},
+        {{"<A> = 10 15|3 10"},                "<A> = 10 15 | 3 10"},
+        {{""},                                ""},
+        {{"    % only a comment"},            ""},
+        {{"<S> = a 1", "<S> = b 2"},          "<S> = a 1 | b 2"},
+        {{"<S> = a<T> 1", "<T> = b 2"},       "<S> = a <T> 1; <T> = b 2"},
+    };
+    const std::vector<Invalid> invalid = {
+        {"<A> = a",                   0, "Rule '<A> = a' is in incorrect format at column 8"},
+        {"<A> = a",                  12, "Rule '<A> = a' is in incorrect format at line 12, column 8"},
+        {"<A> = a % 5",               0, "Rule '<A> = a ' is in incorrect format at column 9"},
+        {"<3> = dddd15| <5> 10",      0, "Rule '<3> = dddd15| <5> 10' is in incorrect format at column 13"},
+        {"<happy birthday> = the 15", 0, "Rule '<happy birthday> = the 15' is in incorrect format at column 7"},
+        {"<1> = <3> | <5>& 15",       0, "Rule '<1> = <3> | <5>& 15' is in incorrect format at column 11"},
+        {"<A> = a 0",                 0, "Rule '<A> = a 0' is in incorrect format at column 9"},
+        {"<A> = a 2147483648",        0, "Rule '<A> = a 2147483648' is in incorrect format at column 9"},
+        {"<A> = a& 15",               0, "Rule '<A> = a& 15' is in incorrect format at column 8"},
+        {"A = a 1",                   0, "Rule 'A = a 1' is in incorrect format at column 1"},
+        {"<A> a 1",                   0, "Rule '<A> a 1' is in incorrect format at column 5"},
+        {"<> = a 1",                  0, "Rule '<> = a 1' is in incorrect format at column 2"},
+        {"<A = a 1",                  0, "Rule '<A = a 1' is in incorrect format at column 3"},
+        {"<A> = <B 1",                0, "Rule '<A> = <B 1' is in incorrect format at column 9"},
+        {"<A> =",                     0, "Rule '<A> =' is in incorrect format at column 6"},
+        {"<A> = a 1 |",               0, "Rule '<A> = a 1 |' is in incorrect format at column 12"},
+        {"<A> = a 1 b 2",             0, "Rule '<A> = a 1 b 2' is in incorrect format at column 11"},
+        {"<A> = `a 1",                0, "Rule '<A> = `a 1' is in incorrect format at column 8"},
+        {"<A> = a` 1",                0, "Rule '<A> = a` 1' is in incorrect format at column 8"},
+        {"<A> = a -1",                0, "Rule '<A> = a -1' is in incorrect format at column 9"},
+    };
+    const std::vector<Incomplete> incomplete = {
+        {{"<START> = a<A> 1"},            "<A> appears on the right but not the left"},
+        {{"<A> = a<START> 1"},            "Missing <START> nonterminal"},
+        {{"<START> = <B><A> 1", "<A> = a 1"}, "<B> appears on the right but not the left"},
+    };
+    const std::vector<Shape> shapes = {
+        {{"<START> = 0<2> 100", "<2> = C<2> 45 | S<2> 45 | F<2> 5 | R<2> 4 | O<2> 1"}, true},
+        {{"<START> = <dir><START> 100", "<dir> = UUUU 25 | DDDD 25 | UDUD 25 | DUDU 25 | UUUD 25 | DDDU 25"},
+         true},
+        {{"<START> = a<START> 1 | b 2"}, true},
+        {{"<START> = ` 1 | a<START> 3"}, true},
+        {{"<START> = <A><B> 1", "<A> = x 1 | y 2", "<B> = z<B> 1 | w 1"}, true},
+        {{"<START> = <A> 1", "<A> = <B> 1 | a 1", "<B> = b<A> 1"}, true},
+        {{"<START> = <START>a 1 | b 1"}, false},
+        {{"<START> = a<START>b 1 | c 1"}, false},
+        {{"<START> = <A><START> 1 | x 1", "<A> = y<A> 1 | z 1"}, false},
+    };
+
+    for(const Parsed &expected : parsed) {
+        ProbCFG cfg;
+        try {
+            for(const std::string &rule : expected.rules) {
+                cfg.addRule(rule);
+            }
+            check(describe(cfg.rules()) == expected.expected, expected.rules[0] + " parsed into " +
+                  describe(cfg.rules()));
+        } catch(const std::runtime_error &error) {
+            check(false, expected.rules[0] + " was rejected: " + error.what());
+        }
+    }
+    for(const Invalid &expected : invalid) {
+        ProbCFG cfg;
+        try {
+            cfg.addRule(expected.rule, expected.line);
+            check(false, expected.rule + " was accepted");
+        } catch(const std::runtime_error &error) {
+            check(error.what() == expected.message, expected.rule + " gave the error " + error.what());
+        }
+    }
+    for(const Incomplete &expected : incomplete) {
+        ProbCFG cfg;
+        try {
+            for(const std::string &rule : expected.rules) {
+                cfg.addRule(rule);
+            }
+            cfg.compile();
+            check(false, expected.rules[0] + " was compiled");
+        } catch(const std::runtime_error &error) {
+            check(error.what() == expected.message, expected.rules[0] + " gave the error " + error.what());
+        }
+    }
+    // Walking a right linear grammar must generate what expanding it does from the same draws
+    for(const Shape &shape : shapes) {
+        ProbCFG cfg;
+        for(const std::string &rule : shape.rules) {
+            cfg.addRule(rule);
+        }
+        cfg.compile();
+        const CompiledCFG &grammar = *cfg.compiled();
+        if(!check(grammar.rightLinear() == shape.rightLinear, shape.rules[0] + " is " +
+                  (shape.rightLinear ? "not " : "") + "right linear") || !shape.rightLinear) {
+            continue;
+        }
+        std::vector<int> stack;
+        for(int steps = 0; steps <= 24; ++steps) {
+            for(uint64_t seed = 1; seed <= 20; ++seed) {
+                Random walkRandom(seed), expandRandom(seed);
+                std::string walked, expanded;
+                grammar.generate(steps, walkRandom, stack, walked);
+                grammar.expand(steps, expandRandom, stack, expanded);
+                check(walked == expanded && walkRandom.generate64() == expandRandom.generate64(),
+                      shape.rules[0] + " walks to " + walked + " but expands to " + expanded + " with " +
+                      std::to_string(steps) + " steps and seed " + std::to_string(seed));
+            }
+        }
+    }
+    // Streaming a string must give what generateString does from the same draws, whatever the grammar's shape
+    for(const Shape &shape : shapes) {
+        ProbCFG cfg;
+        for(const std::string &rule : shape.rules) {
+            cfg.addRule(rule);
+        }
+        cfg.compile();
+        CFGStream stream;
+        for(int steps = 0; steps <= 24; ++steps) {
+            for(uint64_t seed = 1; seed <= 20; ++seed) {
+                Random generateRandom(seed), streamRandom(seed);
+                const std::string generated = cfg.generateString(steps, generateRandom);
+                cfg.stream(steps, streamRandom, stream);
+                std::string streamed;
+                for(char c = stream.next(); c != '\0'; c = stream.next()) {
+                    streamed += c;
+                }
+                check(generated == streamed && generateRandom.generate64() == streamRandom.generate64(),
+                      shape.rules[0] + " generates " + generated + " but streams " + streamed + " with " +
+                      std::to_string(steps) + " steps and seed " + std::to_string(seed));
+            }
+        }
+    }
+    return result();
+}
@@ -0,0 +1,13 @@
+# Checks that rules parse into the same rules and errors as they always have, that right linear grammars walk
+# to what they expand to and that streamed strings are the generated ones
+include(../../comper.pri)
+
+TARGET = probcfg
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+HEADERS += \
+     ../check.h
+
+SOURCES += \
+     probcfg.cpp
@@ -0,0 +1,34 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SAMPLES_H
+#define SAMPLES_H
+#include <string>
+#include <vector>
+
+#include "progression.h" // comper::readProgression
+
+/// The sample files the test programs read with comper::readProgression. The .pro files point SAMPLES_DIR
+/// at the repository
+const std::string SAMPLE_STYLE = SAMPLES_DIR "/sample_style_files/sample.style";
+const std::vector<std::string> SAMPLE_PROGRESSIONS = {
+    SAMPLES_DIR "/sample_progressions/251.progression",
+    SAMPLES_DIR "/sample_progressions/12_bar_blues.progression",
+    SAMPLES_DIR "/sample_progressions/dexterity.progression"
+};
+
+#endif // SAMPLES_H
@@ -0,0 +1,124 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <vector>
+#include <memory> // std::shared_ptr, std::weak_ptr
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <sstream> // std::stringstream
+#include <functional> // std::function
+#include <cstdlib> // mkdtemp
+
+#include <unistd.h> // unlink, rmdir
+
+#include "stylecache.h"
+#include "stylebundle.h"
+#include "random.h"
+#include "../check.h"
+#include "../samples.h"
+
+// Write `text` to `fileName` in one go, so the cache sees it once it's closed
+void writeFile(const std::string &fileName, const std::string &text) {
+    std::ofstream file(fileName);
+    file << text;
+}
+
+// Poll `cache` until `done` is true or a few seconds have gone by. Returns the errors of the last update
+std::vector<std::string> updateUntil(StyleCache &cache, const std::function<bool()> done) {
+    std::vector<std::string> errors;
+    for(int poll = 0; poll < 50 && !done(); ++poll) {
+        errors = cache.update(100);
+    }
+    return errors;
+}
+
+/* A StyleCache over a directory of copies of the sample style must reload only what changed, keep the old
+ * version of a style an edit broke, drop deleted styles, keep every snapshot a reader holds working and free
+ * the ones nobody holds however busy the readers are */
+int main() {
+    char directoryName[] = "/tmp/comper-stylecache-XXXXXX";
+    if(!check(mkdtemp(directoryName) != nullptr, "could not make a directory to watch")) {
+        return result();
+    }
+    const std::string directory = directoryName;
+    std::stringstream sample;
+    sample << std::ifstream(SAMPLE_STYLE).rdbuf();
+    const std::string text = sample.str();
+    writeFile(directory + "/a.style", text);
+    writeFile(directory + "/b.style", text);
+    {
+        StyleCache cache(directory);
+        check(cache.snapshot()->size() == 2, "both styles are loaded");
+        std::shared_ptr<const StyleBundle> a = cache.style("a.style"), b = cache.style("b.style");
+        if(!check(a && b, "both styles can be looked up")) {
+            return result();
+        }
+        // Readers copying snapshots the whole time must not keep replaced ones from being freed
+        std::atomic<bool> reading(true);
+        std::thread reader([&cache, &reading]() {
+            while(reading.load()) {
+                check(cache.snapshot()->size() > 0, "a reader sees an empty snapshot");
+            }
+        });
+        std::shared_ptr<const StyleCache::Snapshot> held = cache.snapshot();
+        std::weak_ptr<const StyleCache::Snapshot> replaced = held;
+
+        // Change one section of a.style
+        std::string edited = text;
+        edited.replace(edited.find("UUUU 25"), 7, "UUUU 50");
+        writeFile(directory + "/a.style", edited);
+        updateUntil(cache, [&]() {return cache.style("a.style") != a;});
+        std::shared_ptr<const StyleBundle> editedA = cache.style("a.style");
+        check(editedA != a, "an edited style is reloaded");
+        check(cache.style("b.style") == b, "an unchanged style is kept");
+        for(const std::string &name : a->names()) {
+            check((editedA->cfg(name) != a->cfg(name)) == (name == "bassDirection"),
+                  "only the changed section [bassDirection] gets a new CFG, not [" + name + "]");
+        }
+
+        // A snapshot held across the reload still generates from the old styles
+        Random random(1);
+        check((*held).at("a.style")->cfg("bassDirection") == a->cfg("bassDirection") &&
+              (*held).at("a.style")->operator[]("bassPattern").generateString(8, random).size() >= 7,
+              "a held snapshot still generates");
+        held = nullptr;
+        updateUntil(cache, [&]() {return replaced.expired();});
+        check(replaced.expired(), "a replaced snapshot is freed once nobody holds it");
+
+        // Break a.style
+        writeFile(directory + "/a.style", "[bassPattern]\n<START> = \n");
+        std::vector<std::string> errors;
+        for(int poll = 0; poll < 50 && errors.empty(); ++poll) {
+            errors = cache.update(100);
+        }
+        check(errors.size() == 1 && errors[0].find("a.style: ") == 0, "a broken style reports an error");
+        check(cache.style("a.style") == editedA, "a broken style keeps its previous version");
+
+        // Delete b.style
+        unlink((directory + "/b.style").c_str());
+        updateUntil(cache, [&]() {return cache.style("b.style") == nullptr;});
+        check(cache.style("b.style") == nullptr && cache.snapshot()->size() == 1, "a deleted style is dropped");
+
+        reading.store(false);
+        reader.join();
+    }
+    unlink((directory + "/a.style").c_str());
+    rmdir(directory.c_str());
+    return result();
+}
@@ -0,0 +1,14 @@
+# Checks that StyleCache reloads only what changed and frees snapshots nobody can still be reading
+include(../../comper.pri)
+
+TARGET = stylecache
+CONFIG += console testcase
+CONFIG -= app_bundle
+DEFINES += SAMPLES_DIR=\\\"$$PWD/../..\\\"
+
+HEADERS += \
+     ../check.h \
+     ../samples.h
+
+SOURCES += \
+     stylecache.cpp
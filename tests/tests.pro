@@ -0,0 +1,16 @@
+# The test programs. `make check` builds and runs them all
+TEMPLATE = subdirs
+
+SUBDIRS += \
+     chordsymbols \
+     probcfg \
+     allocations \
+     walkingbass \
+     compiledstyle \
+     optimalbass \
+     voicelead
+
+# StyleCache uses inotify
+linux {
+    SUBDIRS += stylecache
+}
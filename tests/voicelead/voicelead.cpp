@@ -0,0 +1,150 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <vector>
+#include <climits> // INT_MAX
+#include <algorithm> // std::max, std::min
+#include <functional> // std::function
+#include <cstdlib> // std::abs
+#include <cstdint>
+
+#include "comp.h"
+#include "chord.h"
+#include "chordvalue.h"
+#include "chordsymbol.h"
+#include "note.h"
+#include "random.h"
+#include "../check.h"
+#include "../samples.h"
+
+// The cost model documented on voiceLeadProgression
+const int DIRECTION_COST = 3, DRIFT_COST = 1, FREE_DRIFT = 7;
+
+// What voicing chords with top notes `tops` costs going by `directions`, starting from the top note `reference`
+int voicingCost(const std::vector<int> &tops, const std::vector<comper::Direction> &directions, const int reference) {
+    int cost = 0, previous = reference;
+    for(size_t i = 0; i < tops.size(); ++i) {
+        int move = tops[i] - previous;
+        cost += std::abs(move) + (i > 0 && move != 0 && (move > 0) != directions[i]) * DIRECTION_COST;
+        cost += std::max(0, std::abs(tops[i] - reference) - FREE_DRIFT) * DRIFT_COST;
+        previous = tops[i];
+    }
+    return cost;
+}
+
+// Return the top note of every chord of `progression`
+std::vector<int> topNotes(const std::vector<ChordValue> &progression) {
+    std::vector<int> tops;
+    for(const ChordValue &chord : progression) {
+        tops.push_back(chord.top().number());
+    }
+    return tops;
+}
+
+/* voiceLeadProgression must voice every chord with one of the voicings within an octave of the reference, the
+ * same way every time, for no more than voicing one chord at a time like genComping does. For short songs it
+ * must cost exactly as little as the cheapest of every way to voice them */
+int main() {
+    const std::vector<std::vector<int>> voicings = {{3, 6, 7, 9}, {7, 9, 3, 5}};
+    static const std::vector<int> rootOnly = {1};
+    const Note referenceNote("G", 5);
+    const ChordValue referenceChord(ChordSymbol::intern(referenceNote.name()), referenceNote.octave(), rootOnly);
+    const int reference = referenceChord.top().number();
+    for(const std::string &fileName : SAMPLE_PROGRESSIONS) {
+        for(int repetitions : {1, 4}) {
+            std::vector<ChordValue> chords;
+            for(const comper::quarterNoteChord &chord : comper::readProgression(fileName, repetitions)) {
+                chords.push_back(chord.value());
+            }
+            // Every voicing can be tried on songs of up to 8 chords
+            const bool bruteForce = chords.size() <= 8;
+            for(uint64_t seed = 1; seed <= 20; ++seed) {
+                const std::string what = fileName + " repeated " + std::to_string(repetitions) +
+                        " times with seed " + std::to_string(seed);
+                Random random(seed);
+                std::vector<comper::Direction> directions;
+                for(size_t i = 0; i < chords.size(); ++i) {
+                    directions.push_back((comper::Direction)(random.bounded(2) == 1));
+                }
+                std::vector<ChordValue> optimal = chords, again = chords;
+                comper::voiceLeadProgression(optimal, referenceChord, voicings, directions);
+                comper::voiceLeadProgression(again, referenceChord, voicings, directions);
+                check(optimal == again, "the same directions give other voicings for " + what);
+                bool voiced = true, inRange = true;
+                for(size_t i = 0; i < chords.size(); ++i) {
+                    bool found = false;
+                    for(const std::vector<int> &voicing : voicings) {
+                        const ChordValue withVoicing = chords[i].withVoicing(voicing);
+                        found = found || optimal[i] == withVoicing.withOctave(optimal[i].octave());
+                    }
+                    voiced = voiced && found;
+                    inRange = inRange && std::abs(optimal[i].top().number() - reference) <= NUM_NOTES;
+                }
+                check(voiced, "a chord isn't given one of the voicings for " + what);
+                check(inRange, "a top note is more than an octave from the reference for " + what);
+
+                // Voice one chord at a time the way genComping does without optimalVoicing
+                std::vector<ChordValue> greedy = chords;
+                int quarterNotes = 0;
+                for(size_t i = 0; i < greedy.size(); ++i) {
+                    if(quarterNotes % 16 == 0) {
+                        comper::voiceLead(greedy[i], referenceChord, voicings, comper::Down);
+                    } else {
+                        comper::voiceLead(greedy[i], greedy[i - 1], voicings, directions[i]);
+                    }
+                    quarterNotes += greedy[i].duration();
+                }
+                const int cost = voicingCost(topNotes(optimal), directions, reference);
+                const int greedyCost = voicingCost(topNotes(greedy), directions, reference);
+                check(cost <= greedyCost, "the voicings cost " + std::to_string(cost) + ", more than the greedy " +
+                      std::to_string(greedyCost) + " for " + what);
+                if(bruteForce) {
+                    // Every top note each chord can have within an octave of the reference
+                    std::vector<std::vector<int>> candidates(chords.size());
+                    for(size_t i = 0; i < chords.size(); ++i) {
+                        for(const std::vector<int> &voicing : voicings) {
+                            int top = chords[i].withVoicing(voicing).top().number();
+                            for(int shift = -8; shift <= 8; ++shift) {
+                                if(std::abs(top + NUM_NOTES * shift - reference) <= NUM_NOTES) {
+                                    candidates[i].push_back(top + NUM_NOTES * shift);
+                                }
+                            }
+                        }
+                    }
+                    int cheapest = INT_MAX;
+                    std::vector<int> tops;
+                    std::function<void()> tryEvery = [&]() {
+                        if(tops.size() == chords.size()) {
+                            cheapest = std::min(cheapest, voicingCost(tops, directions, reference));
+                            return;
+                        }
+                        for(int top : candidates[tops.size()]) {
+                            tops.push_back(top);
+                            tryEvery();
+                            tops.pop_back();
+                        }
+                    };
+                    tryEvery();
+                    check(cost == cheapest, "the voicings cost " + std::to_string(cost) + " but some cost " +
+                          std::to_string(cheapest) + " for " + what);
+                }
+            }
+        }
+    }
+    return result();
+}
@@ -0,0 +1,14 @@
+# Checks that voiceLeadProgression finds the cheapest voicings
+include(../../comper.pri)
+
+TARGET = voicelead
+CONFIG += console testcase
+CONFIG -= app_bundle
+DEFINES += SAMPLES_DIR=\\\"$$PWD/../..\\\"
+
+HEADERS += \
+     ../check.h \
+     ../samples.h
+
+SOURCES += \
+     voicelead.cpp
@@ -0,0 +1,59 @@
+/*
+This file is part of Comper.
+
+Comper is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Comper is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Comper.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "simpleBassline.h"
+#include "walkingbass.h"
+#include "stylebundle.h"
+#include "note.h"
+#include "notevalue.h"
+#include "random.h"
+#include "../check.h"
+#include "../samples.h"
+
+/* genWalkingBassline must give the same notes as genSimpleWalkingBassline for the same state of Random
+ * and leave it in the same state, so that everything drawn after the bassline is the same too */
+int main() {
+    StyleBundle style;
+    style.fromFile(SAMPLE_STYLE);
+    const ProbCFG &pattern = style["bassPattern"], &direction = style["bassDirection"];
+    const Note lowest("C", 3), highest("G", 3);
+    for(const std::string &fileName : SAMPLE_PROGRESSIONS) {
+        for(int repetitions : {1, 4, 20}) {
+            const std::vector<Chord> progression = comper::readProgression(fileName, repetitions);
+            for(uint64_t seed = 1; seed <= 30; ++seed) {
+                const std::string what = fileName + " repeated " + std::to_string(repetitions) +
+                        " times with seed " + std::to_string(seed);
+                Random simpleRandom(seed, 0), random(seed, 0);
+                const std::vector<Note> expected = comper::genSimpleWalkingBassline(progression, pattern,
+                        direction, lowest, highest, simpleRandom);
+                const std::vector<NoteValue> bassline = comper::genWalkingBassline(progression, pattern,
+                        direction, lowest, highest, random);
+                bool same = expected.size() == bassline.size();
+                for(size_t i = 0; same && i < bassline.size(); ++i) {
+                    same = expected[i].value() == bassline[i];
+                }
+                check(same, "the basslines differ for " + what);
+                check(simpleRandom.generate64() == random.generate64(), "Random ends up elsewhere for " + what);
+            }
+        }
+    }
+    return result();
+}
@@ -0,0 +1,14 @@
+# Checks that genWalkingBassline gives the same basslines as genSimpleWalkingBassline
+include(../../comper.pri)
+
+TARGET = walkingbass
+CONFIG += console testcase
+CONFIG -= app_bundle
+DEFINES += SAMPLES_DIR=\\\"$$PWD/../..\\\"
+
+HEADERS += \
+     ../check.h \
+     ../samples.h
+
+SOURCES += \
+     walkingbass.cpp